@@ -0,0 +1,974 @@
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "g_benchmark.hpp"
+#include "g_benchmark_export.hpp"
+#include "g_print_table.hpp"
+#include "g_test_framework.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr int TimerCalibrationSamples{1001};
+constexpr int64_t MaxIterationsPerBatch{1'000'000'000};
+
+const vector<int> benchmarkResultsTableColumnWidths{4, 30, 12, 14, 14, 14, 10};
+const auto defaultTableColumnColors =
+    vector<string>(benchmarkResultsTableColumnWidths.size(), PrintColor::Reset);
+
+void printBenchmarkResultTableHeader() {
+    printTableRow(benchmarkResultsTableColumnWidths, defaultTableColumnColors, "#", "Benchmark",
+                  "Iterations", "Mean [ns]", "Median [ns]", "StdDev [ns]", "Status");
+}
+
+string nanosecondsText(double nanoseconds) {
+    stringstream text;
+    text << fixed << setprecision(nanoseconds < 100.0 ? 2 : 1) << nanoseconds;
+    return text.str();
+}
+
+void printBenchmarkResultTableRow(int benchmarkNo, const BenchmarkResult &result) {
+    vector<string> colors{defaultTableColumnColors};
+    constexpr auto statusColumn{6};
+
+    if (result.error) {
+        colors[statusColumn] = PrintColor::Magenta;
+        printTableRow(benchmarkResultsTableColumnWidths, colors, benchmarkNo, result.getDisplayName(),
+                      result.iterationsPerBatch, "-", "-", "-", "ERROR");
+        return;
+    }
+
+    colors[statusColumn] = PrintColor::Green;
+    printTableRow(benchmarkResultsTableColumnWidths, colors, benchmarkNo, result.getDisplayName(),
+                  result.iterationsPerBatch, nanosecondsText(result.mean), nanosecondsText(result.median),
+                  nanosecondsText(result.standardDeviation), "OK");
+}
+
+struct RowNameParts {
+    bool withThreads{true};
+    bool withCacheMode{true};
+};
+
+/**
+ * @brief Gives the display name of a result without the parts given by the other columns of a table.
+ */
+string rowName(const BenchmarkResult &result, RowNameParts parts) {
+    string name{result.benchmarkName};
+    if (result.range) {
+        name += "/" + to_string(*result.range);
+    }
+    if (result.threads && parts.withThreads) {
+        name += "/threads:" + to_string(*result.threads);
+    }
+    if (result.cacheMode && parts.withCacheMode) {
+        stringstream cacheMode;
+        cacheMode << *result.cacheMode;
+        name += "/" + cacheMode.str();
+    }
+    return name;
+}
+
+/**
+ * @brief Prints the latency percentiles of the benchmarks recording latencies.
+ */
+void printLatencyTable(const vector<const BenchmarkBase *> &benchmarks) {
+    const vector<int> latencyTableColumnWidths{4, 30, 12, 12, 12, 12, 12};
+    const auto colors = vector<string>(latencyTableColumnWidths.size(), PrintColor::Reset);
+    bool isHeaderPrinted{false};
+    int rowNo{0};
+
+    for (const auto *benchmark : benchmarks) {
+        for (const auto &result : benchmark->getResults()) {
+            if (!result.latencies || result.error) {
+                continue;
+            }
+
+            if (!isHeaderPrinted) {
+                cout << endl << "LATENCY:" << endl;
+                printTableRow(latencyTableColumnWidths, colors, "#", "Benchmark", "p50 [ns]", "p90 [ns]",
+                              "p99 [ns]", "p99.9 [ns]", "Max [ns]");
+                isHeaderPrinted = true;
+            }
+
+            const auto &latencies = *result.latencies;
+            printTableRow(latencyTableColumnWidths, colors, ++rowNo, result.getDisplayName(),
+                          latencies.percentile(50.0), latencies.percentile(90.0), latencies.percentile(99.0),
+                          latencies.percentile(99.9), latencies.getMax());
+        }
+    }
+}
+
+string perIterationText(const optional<uint64_t> &value, double iterations) {
+    if (!value) {
+        return "n/a";
+    }
+    stringstream text;
+    text << fixed << setprecision(2) << static_cast<double>(*value) / iterations;
+    return text.str();
+}
+
+/**
+ * @brief Prints the hardware performance counters of the benchmarks per iteration.
+ */
+void printPerfCounterTable(const vector<const BenchmarkBase *> &benchmarks) {
+    const vector<int> perfCounterTableColumnWidths{4, 30, 16, 16, 16, 16};
+    const auto colors = vector<string>(perfCounterTableColumnWidths.size(), PrintColor::Reset);
+    bool isHeaderPrinted{false};
+    int rowNo{0};
+
+    for (const auto *benchmark : benchmarks) {
+        for (const auto &result : benchmark->getResults()) {
+            if (!result.perfCounters || result.error) {
+                continue;
+            }
+
+            if (!isHeaderPrinted) {
+                cout << endl << "PERFORMANCE COUNTERS PER ITERATION:" << endl;
+                printTableRow(perfCounterTableColumnWidths, colors, "#", "Benchmark", "Instructions",
+                              "Cycles", "Cache Misses", "Branch Misses");
+                isHeaderPrinted = true;
+            }
+
+            const auto &values = *result.perfCounters;
+            const auto iterations = static_cast<double>(result.iterationsPerBatch) *
+                                    static_cast<double>(result.nanosecondsPerIteration.size()) *
+                                    result.threads.value_or(1);
+            printTableRow(perfCounterTableColumnWidths, colors, ++rowNo, result.getDisplayName(),
+                          perIterationText(values.instructions, iterations),
+                          perIterationText(values.cycles, iterations),
+                          perIterationText(values.cacheMisses, iterations),
+                          perIterationText(values.branchMisses, iterations));
+        }
+    }
+
+    if (!isHeaderPrinted) {
+        cout << endl << "PERFORMANCE COUNTERS: not available on this system." << endl;
+    }
+}
+
+/**
+ * @brief Prints the user counters of the benchmarks, one row per counter.
+ */
+void printCounterTable(const vector<const BenchmarkBase *> &benchmarks) {
+    const vector<int> counterTableColumnWidths{4, 30, 20, 10, 16};
+    const auto colors = vector<string>(counterTableColumnWidths.size(), PrintColor::Reset);
+    bool isHeaderPrinted{false};
+    int rowNo{0};
+
+    for (const auto *benchmark : benchmarks) {
+        for (const auto &result : benchmark->getResults()) {
+            if (result.counters.empty() || result.error) {
+                continue;
+            }
+
+            if (!isHeaderPrinted) {
+                cout << endl << "COUNTERS:" << endl;
+                printTableRow(counterTableColumnWidths, colors, "#", "Benchmark", "Counter", "Kind", "Value");
+                isHeaderPrinted = true;
+            }
+
+            for (const auto &counter : result.counters) {
+                stringstream kind;
+                kind << counter.kind;
+                printTableRow(counterTableColumnWidths, colors, ++rowNo, result.getDisplayName(),
+                              counter.name, kind.str(), counterValueText(counter));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Prints the mean times of the benchmarks measured with both warm and cold caches side by side.
+ */
+void printCacheTable(const vector<const BenchmarkBase *> &benchmarks) {
+    const vector<int> cacheTableColumnWidths{4, 30, 10, 14, 14, 10};
+    const auto colors = vector<string>(cacheTableColumnWidths.size(), PrintColor::Reset);
+    bool isHeaderPrinted{false};
+    int rowNo{0};
+
+    for (const auto *benchmark : benchmarks) {
+        const auto &results = benchmark->getResults();
+
+        for (const auto &cold : results) {
+            if (!cold.cacheMode || *cold.cacheMode == CacheMode::Warm || cold.error) {
+                continue;
+            }
+
+            const auto warm = ranges::find_if(results, [&](const BenchmarkResult &result) {
+                return result.cacheMode == CacheMode::Warm && result.range == cold.range &&
+                       result.threads == cold.threads && !result.error;
+            });
+            if (warm == results.end()) {
+                continue;
+            }
+
+            if (!isHeaderPrinted) {
+                cout << endl << "CACHES:" << endl;
+                printTableRow(cacheTableColumnWidths, colors, "#", "Benchmark", "Mode", "Warm [ns]",
+                              "Cold [ns]", "Cold/Warm");
+                isHeaderPrinted = true;
+            }
+
+            stringstream mode;
+            mode << *cold.cacheMode;
+            stringstream ratio;
+            ratio << fixed << setprecision(2) << (warm->mean > 0.0 ? cold.mean / warm->mean : 0.0) << 'x';
+
+            printTableRow(cacheTableColumnWidths, colors, ++rowNo,
+                          rowName(cold, {.withThreads = true, .withCacheMode = false}), mode.str(),
+                          nanosecondsText(warm->mean), nanosecondsText(cold.mean), ratio.str());
+        }
+    }
+}
+
+/**
+ * @brief Prints how the throughput of the multithreaded benchmarks scales with the number of threads,
+ * relative to the smallest number of threads.
+ */
+void printScalingTable(const vector<const BenchmarkBase *> &benchmarks) {
+    const vector<int> scalingTableColumnWidths{4, 30, 8, 16, 10, 12};
+    const auto defaultColors = vector<string>(scalingTableColumnWidths.size(), PrintColor::Reset);
+    constexpr auto efficiencyColumn{5};
+    bool isHeaderPrinted{false};
+    int rowNo{0};
+
+    for (const auto *benchmark : benchmarks) {
+        const BenchmarkResult *baseline = nullptr;
+
+        for (const auto &result : benchmark->getResults()) {
+            if (!result.threads || result.error) {
+                continue;
+            }
+            if (baseline == nullptr || baseline->range != result.range ||
+                baseline->cacheMode != result.cacheMode) {
+                baseline = &result;
+            }
+
+            if (!isHeaderPrinted) {
+                cout << endl << "SCALING:" << endl;
+                printTableRow(scalingTableColumnWidths, defaultColors, "#", "Benchmark", "Threads",
+                              "Iterations/s", "Speedup", "Efficiency");
+                isHeaderPrinted = true;
+            }
+
+            const auto speedup = baseline->iterationsPerSecond > 0.0
+                                     ? result.iterationsPerSecond / baseline->iterationsPerSecond
+                                     : 0.0;
+            const auto efficiency = speedup * *baseline->threads / *result.threads;
+
+            auto colors = defaultColors;
+            colors[efficiencyColumn] = efficiency >= 0.75   ? PrintColor::Green
+                                       : efficiency >= 0.5 ? PrintColor::Yellow
+                                                           : PrintColor::Red;
+
+            stringstream speedupText;
+            speedupText << fixed << setprecision(2) << speedup << 'x';
+            stringstream efficiencyText;
+            efficiencyText << fixed << setprecision(1) << 100.0 * efficiency << '%';
+
+            const auto name = rowName(result, {.withThreads = false, .withCacheMode = true});
+            printTableRow(scalingTableColumnWidths, colors, ++rowNo, name, *result.threads,
+                          static_cast<int64_t>(result.iterationsPerSecond), speedupText.str(),
+                          efficiencyText.str());
+        }
+    }
+}
+
+double complexityFunction(Complexity complexity, double n) {
+    switch (complexity) {
+    case Complexity::O1:
+        return 1.0;
+    case Complexity::OLogN:
+        return log2(n);
+    case Complexity::ON:
+        return n;
+    case Complexity::ONLogN:
+        return n * log2(n);
+    case Complexity::ON2:
+        return n * n;
+    default:
+        return 0.0;
+    }
+}
+
+optional<ComplexityFit> fitSingleComplexity(span<const int64_t> ranges, span<const double> nanoseconds,
+                                            Complexity complexity) {
+    // Least squares fit of time = coefficient * f(n).
+    double sumOfTimesF{0.0};
+    double sumOfSquaredF{0.0};
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const auto f = complexityFunction(complexity, static_cast<double>(ranges[i]));
+        sumOfTimesF += nanoseconds[i] * f;
+        sumOfSquaredF += f * f;
+    }
+
+    if (sumOfSquaredF == 0.0) {
+        return nullopt;
+    }
+
+    const auto coefficient = sumOfTimesF / sumOfSquaredF;
+    double sumOfSquaredErrors{0.0};
+    double sumOfTimes{0.0};
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        const auto f = complexityFunction(complexity, static_cast<double>(ranges[i]));
+        const auto error = nanoseconds[i] - coefficient * f;
+        sumOfSquaredErrors += error * error;
+        sumOfTimes += nanoseconds[i];
+    }
+
+    const auto numberOfPoints = static_cast<double>(ranges.size());
+    const auto meanTime = sumOfTimes / numberOfPoints;
+    const auto rms = meanTime > 0.0 ? sqrt(sumOfSquaredErrors / numberOfPoints) / meanTime : 0.0;
+
+    return ComplexityFit{.complexity = complexity, .coefficient = coefficient, .rms = rms};
+}
+
+} // namespace
+
+ostream &operator<<(ostream &os, Complexity complexity) {
+    switch (complexity) {
+    case Complexity::O1:
+        return os << "O(1)";
+    case Complexity::OLogN:
+        return os << "O(log n)";
+    case Complexity::ON:
+        return os << "O(n)";
+    case Complexity::ONLogN:
+        return os << "O(n log n)";
+    case Complexity::ON2:
+        return os << "O(n^2)";
+    case Complexity::Auto:
+        return os << "auto";
+    default:
+        return os << "none";
+    }
+}
+
+ostream &operator<<(ostream &os, CacheMode cacheMode) {
+    switch (cacheMode) {
+    case CacheMode::Cold:
+        return os << "cold";
+    case CacheMode::ColdTlb:
+        return os << "cold-tlb";
+    default:
+        return os << "warm";
+    }
+}
+
+ComplexityFit fitComplexity(span<const int64_t> ranges, span<const double> nanoseconds,
+                            Complexity complexity) {
+    if (complexity != Complexity::Auto) {
+        return fitSingleComplexity(ranges, nanoseconds, complexity).value_or(ComplexityFit{});
+    }
+
+    ComplexityFit bestFit;
+    for (auto candidate :
+         {Complexity::O1, Complexity::OLogN, Complexity::ON, Complexity::ONLogN, Complexity::ON2}) {
+        const auto fit = fitSingleComplexity(ranges, nanoseconds, candidate);
+        if (fit && (bestFit.complexity == Complexity::None || fit->rms < bestFit.rms)) {
+            bestFit = *fit;
+        }
+    }
+
+    return bestFit;
+}
+
+bool BenchmarkState::startOrStopTiming() {
+    const bool isSeparateIterations = latencyHistogram_ != nullptr || cacheFlusher_ != nullptr;
+
+    if (!isStarted_) {
+        isStarted_ = true;
+        // When iterations are measured separately every call comes here, which keeps the fast path free
+        // from it.
+        remainingIterations_ = isSeparateIterations ? 0 : iterations_ - 1;
+        remainingSeparateIterations_ = iterations_;
+        if (iterations_ > 0) {
+            flushCaches();
+        }
+        if (startBarrier_ != nullptr) {
+            startBarrier_->arrive_and_wait();
+        }
+        if (perfCounters_ != nullptr) {
+            perfCounters_->start();
+        }
+        startTime_ = Clock::now();
+        return iterations_ > 0;
+    }
+
+    if (isSeparateIterations && !isFinished_) {
+        endIteration();
+        const bool isCounting = perfCounters_ != nullptr && !isPaused_;
+        if (--remainingSeparateIterations_ > 0) {
+            if (cacheFlusher_ != nullptr) {
+                if (isCounting) {
+                    perfCounters_->pause();
+                }
+                flushCaches();
+                if (isCounting) {
+                    perfCounters_->resume();
+                }
+                startTime_ = Clock::now();
+            }
+            return true;
+        }
+        isFinished_ = true;
+        if (isCounting) {
+            perfCounters_->pause();
+        }
+        return false;
+    }
+
+    if (!isFinished_) {
+        isFinished_ = true;
+        if (!isPaused_) {
+            measuredTime_ += Clock::now() - startTime_;
+            ++numberOfMeasuredRegions_;
+            if (perfCounters_ != nullptr) {
+                perfCounters_->pause();
+            }
+        }
+    }
+
+    return false;
+}
+
+void BenchmarkState::pauseTiming() {
+    if (isStarted_ && !isPaused_) {
+        const auto regionTime = Clock::now() - startTime_;
+        measuredTime_ += regionTime;
+        ++numberOfMeasuredRegions_;
+        iterationTime_ += regionTime;
+        ++iterationRegions_;
+        isPaused_ = true;
+        if (perfCounters_ != nullptr) {
+            perfCounters_->pause();
+        }
+    }
+}
+
+void BenchmarkState::resumeTiming() {
+    if (isPaused_) {
+        isPaused_ = false;
+        if (perfCounters_ != nullptr) {
+            perfCounters_->resume();
+        }
+        startTime_ = Clock::now();
+    }
+}
+
+void BenchmarkState::endIteration() {
+    // One clock read ends an iteration and starts the next one, unless the caches are flushed in between.
+    const auto now = Clock::now();
+    if (!isPaused_) {
+        const auto regionTime = now - startTime_;
+        measuredTime_ += regionTime;
+        ++numberOfMeasuredRegions_;
+        iterationTime_ += regionTime;
+        ++iterationRegions_;
+        startTime_ = now;
+    }
+
+    if (latencyHistogram_ != nullptr) {
+        const auto latency =
+            chrono::duration_cast<chrono::nanoseconds>(iterationTime_ - iterationRegions_ * timerOverhead_);
+        latencyHistogram_->record(static_cast<uint64_t>(max<int64_t>(0, latency.count())));
+    }
+
+    iterationTime_ = Clock::duration::zero();
+    iterationRegions_ = 0;
+}
+
+void BenchmarkState::flushCaches() const {
+    if (cacheFlusher_ == nullptr) {
+        return;
+    }
+
+    if (cacheMode_ == CacheMode::ColdTlb) {
+        cacheFlusher_->flushTlb();
+    } else {
+        cacheFlusher_->flushCaches();
+    }
+}
+
+void BenchmarkResult::computeStatistics() {
+    const auto &samples = nanosecondsPerIteration;
+    if (samples.empty()) {
+        return;
+    }
+
+    const auto numberOfSamples = static_cast<double>(samples.size());
+    mean = accumulate(samples.begin(), samples.end(), 0.0) / numberOfSamples;
+
+    auto sorted = samples;
+    ranges::sort(sorted);
+    const auto middle = sorted.size() / 2;
+    median = sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    minimum = sorted.front();
+
+    double sumOfSquares{0.0};
+    for (auto sample : samples) {
+        sumOfSquares += (sample - mean) * (sample - mean);
+    }
+    standardDeviation = samples.size() > 1 ? sqrt(sumOfSquares / (numberOfSamples - 1)) : 0.0;
+}
+
+string BenchmarkResult::getDisplayName() const { return rowName(*this, {}); }
+
+void BenchmarkFramework::registerBenchmark(BenchmarkBase &benchmark) {
+    if (lastBenchmark_ == nullptr) {
+        firstBenchmark_ = &benchmark;
+    } else {
+        lastBenchmark_->nextBenchmark_ = &benchmark;
+    }
+    lastBenchmark_ = &benchmark;
+}
+
+void BenchmarkFramework::executeBenchmarks() { executeBenchmarks(string_view{}); }
+
+void BenchmarkFramework::printEnvironment(const vector<int> &unavailableCpus) const {
+    cout << "BENCHMARK ENVIRONMENT:" << endl << environment_;
+
+    auto warnings = environment_.getWarnings();
+    if (highPriority_ && !environment_.isHighPriority) {
+        warnings.emplace_back("Could not raise the priority of the process.");
+    }
+    if (!cpuAffinity_.empty() && environment_.pinnedCpus.empty()) {
+        warnings.emplace_back("Could not pin the benchmark threads to the CPUs, they are not pinned.");
+    }
+    for (auto cpu : unavailableCpus) {
+        warnings.push_back("CPU " + to_string(cpu) + " is not available, the threads may not be pinned.");
+    }
+
+    for (const auto &warning : warnings) {
+        cout << "  " << PrintColor::Yellow << "Warning: " << warning << PrintColor::Reset << endl;
+    }
+    cout << endl;
+}
+
+void BenchmarkFramework::executeBenchmarks(string_view filter) {
+    int numberOfExecutedBenchmarks{0};
+    int numberOfResults{0};
+    vector<const BenchmarkBase *> executedBenchmarks;
+
+    environment_ = BenchmarkEnvironment::detect();
+    if (highPriority_) {
+        environment_.isHighPriority = raiseProcessPriority();
+    }
+
+    // Checked before the calling thread is pinned, which restricts its affinity to the first CPU.
+    vector<int> unavailableCpus;
+    ranges::copy_if(cpuAffinity_, back_inserter(unavailableCpus),
+                    [](int cpu) { return !isCpuAvailable(cpu); });
+
+    // The calling thread executes the single threaded benchmarks.
+    const ScopedCpuAffinity callingThreadAffinity{cpuAffinity_.empty() ? vector<int>{}
+                                                                        : vector<int>{cpuAffinity_.front()}};
+    if (callingThreadAffinity.isPinned()) {
+        environment_.pinnedCpus = cpuAffinity_;
+    }
+    printEnvironment(unavailableCpus);
+    isThreadPinningFailed_ = false;
+
+    BenchmarkResultWriter resultWriter{resultsJsonFile_, resultsCsvFile_};
+    resultWriter.writeHeader(environment_, getTimerOverhead());
+
+    printBenchmarkResultTableHeader();
+
+    for (auto *benchmark = firstBenchmark_; benchmark != nullptr; benchmark = benchmark->nextBenchmark_) {
+        if (!TestFramework::matchesFilter(benchmark->getBenchmarkName(), filter)) {
+            continue;
+        }
+
+        benchmark->execute();
+        resultWriter.writeResults(*benchmark);
+        executedBenchmarks.push_back(benchmark);
+        ++numberOfExecutedBenchmarks;
+
+        for (const auto &result : benchmark->getResults()) {
+            printBenchmarkResultTableRow(++numberOfResults, result);
+        }
+    }
+
+    cout << endl;
+    cout << "BENCHMARK SUMMARY: " << numberOfExecutedBenchmarks << " benchmarks executed, timer overhead "
+         << getTimerOverhead().count() << " ns subtracted per measured region." << endl;
+    cout << endl;
+
+    for (const auto *benchmark : executedBenchmarks) {
+        for (const auto &result : benchmark->getResults()) {
+            if (result.error) {
+                cout << "# Error: " << result.getDisplayName() << " | " << *result.error << endl;
+            }
+        }
+    }
+
+    if (isThreadPinningFailed_) {
+        cout << "# Warning: Some threads of multithreaded benchmarks could not be pinned to their CPU."
+             << endl;
+    }
+
+    for (const auto *benchmark : executedBenchmarks) {
+        const auto &fit = benchmark->getComplexityFit();
+        if (!fit) {
+            continue;
+        }
+
+        const auto expected = benchmark->getOptions().complexity;
+        cout << "# Complexity: " << benchmark->getBenchmarkName() << " ~ " << fit->complexity << ", "
+             << nanosecondsText(fit->coefficient) << " ns * f(n), RMS " << fixed << setprecision(1)
+             << 100.0 * fit->rms << defaultfloat << "%";
+        if (expected != Complexity::Auto && fit->complexity > expected) {
+            cout << " | " << PrintColor::Red << "REGRESSION" << PrintColor::Reset << ", expected "
+                 << expected;
+        }
+        cout << endl;
+    }
+
+    printLatencyTable(executedBenchmarks);
+    if (isPerfCountersEnabled_) {
+        printPerfCounterTable(executedBenchmarks);
+    }
+    printCounterTable(executedBenchmarks);
+    printCacheTable(executedBenchmarks);
+    printScalingTable(executedBenchmarks);
+
+    cout << endl << endl;
+}
+
+void BenchmarkFramework::executeBenchmarks(int argc, char *argv[]) {
+    string_view filter;
+
+    for (int i = 1; i < argc; ++i) {
+        const string_view argument{argv[i]};
+        constexpr string_view filterOption{"--filter="};
+        constexpr string_view cpusOption{"--cpus="};
+        constexpr string_view resultsJsonOption{"--results-json="};
+        constexpr string_view resultsCsvOption{"--results-csv="};
+
+        if (argument.starts_with(filterOption)) {
+            filter = argument.substr(filterOption.size());
+        } else if (argument.starts_with(cpusOption)) {
+            if (const auto cpus = parseCpuList(argument.substr(cpusOption.size()))) {
+                setCpuAffinity(*cpus);
+            } else {
+                cerr << "Ignoring invalid CPU list: " << argument << endl;
+            }
+        } else if (argument == "--high-priority") {
+            setHighPriority(true);
+        } else if (argument.starts_with(resultsJsonOption)) {
+            setResultsJsonFile(argument.substr(resultsJsonOption.size()));
+        } else if (argument.starts_with(resultsCsvOption)) {
+            setResultsCsvFile(argument.substr(resultsCsvOption.size()));
+        } else {
+            cerr << "Ignoring unknown option: " << argument << endl;
+        }
+    }
+
+    executeBenchmarks(filter);
+}
+
+chrono::nanoseconds BenchmarkFramework::getTimerOverhead() {
+    if (!timerOverhead_) {
+        using Clock = chrono::steady_clock;
+
+        // An empty measured region costs the part of the two clock reads that falls between the samples.
+        // The median is used so that interrupts during the calibration do not inflate the overhead.
+        vector<Clock::duration> samples(TimerCalibrationSamples);
+        for (auto &sample : samples) {
+            const auto start = Clock::now();
+            sample = Clock::now() - start;
+        }
+
+        ranges::nth_element(samples, samples.begin() + TimerCalibrationSamples / 2);
+        timerOverhead_ = chrono::duration_cast<chrono::nanoseconds>(samples[TimerCalibrationSamples / 2]);
+    }
+
+    return *timerOverhead_;
+}
+
+const CacheFlusher &BenchmarkFramework::getCacheFlusher() {
+    if (!cacheFlusher_) {
+        cacheFlusher_ = make_unique<CacheFlusher>(environment_.lastLevelCacheSize);
+    }
+    return *cacheFlusher_;
+}
+
+vector<int64_t> BenchmarkBase::getRanges() const {
+    if (options_.rangeEnd == 0) {
+        return {0};
+    }
+
+    vector<int64_t> ranges;
+    const auto multiplier = max<int64_t>(2, options_.rangeMultiplier);
+    for (auto range = max<int64_t>(1, options_.rangeBegin); range < options_.rangeEnd; range *= multiplier) {
+        ranges.push_back(range);
+    }
+    ranges.push_back(options_.rangeEnd);
+
+    return ranges;
+}
+
+vector<int> BenchmarkBase::getThreadCounts() const {
+    vector<int> threadCounts;
+    for (auto threads = max(1, options_.minThreads); threads < options_.maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(max({1, options_.minThreads, options_.maxThreads}));
+
+    return threadCounts;
+}
+
+vector<CacheMode> BenchmarkBase::getCacheModes() const {
+    if (options_.cacheMode == CacheMode::Warm) {
+        return {CacheMode::Warm};
+    }
+    if (options_.compareWithWarm) {
+        return {CacheMode::Warm, options_.cacheMode};
+    }
+    return {options_.cacheMode};
+}
+
+void BenchmarkBase::execute() {
+    const auto rangeArguments = getRanges();
+    const auto cacheModes = getCacheModes();
+    const auto threadCounts = getThreadCounts();
+    const bool isMultithreaded = threadCounts.back() > 1;
+
+    results_.clear();
+    complexityFit_.reset();
+
+    for (auto range : rangeArguments) {
+        for (auto cacheMode : cacheModes) {
+            for (auto threads : threadCounts) {
+                auto &result = results_.emplace_back();
+                result.benchmarkName = benchmarkName_;
+                if (options_.rangeEnd != 0) {
+                    result.range = range;
+                }
+                if (isMultithreaded) {
+                    result.threads = threads;
+                }
+                if (options_.cacheMode != CacheMode::Warm) {
+                    result.cacheMode = cacheMode;
+                }
+                measure(result);
+            }
+        }
+    }
+
+    const bool allMeasured = ranges::none_of(results_, [](const auto &result) { return !!result.error; });
+    if (options_.complexity == Complexity::None || rangeArguments.size() < 3 || !allMeasured) {
+        return;
+    }
+
+    // The complexity is fitted to the results with the first cache mode and the smallest number of threads.
+    vector<double> meanTimes;
+    for (size_t i = 0; i < results_.size(); i += cacheModes.size() * threadCounts.size()) {
+        meanTimes.push_back(results_[i].mean);
+    }
+
+    // The best fit is reported also when a complexity is expected, so that a regression becomes visible.
+    complexityFit_ = fitComplexity(rangeArguments, meanTimes, Complexity::Auto);
+    if (complexityFit_->complexity == Complexity::None) {
+        complexityFit_.reset();
+    }
+}
+
+void BenchmarkBase::measure(BenchmarkResult &result) {
+    const auto range = result.range.value_or(0);
+    const auto threads = result.threads.value_or(1);
+    const auto cacheMode = result.cacheMode.value_or(CacheMode::Warm);
+
+    // Each iteration with cold caches is preceded by a flush, which is not measured but takes long.
+    const auto maxIterations = cacheMode == CacheMode::Warm
+                                   ? MaxIterationsPerBatch
+                                   : clamp<int64_t>(options_.maxColdIterations, 1, MaxIterationsPerBatch);
+
+    try {
+        const auto minBatchDuration = options_.minBatchDuration;
+
+        // Increase the number of iterations until a batch is long enough to be measured accurately.
+        int64_t iterations{1};
+        for (;;) {
+            const auto threadTimes = runBatch(iterations, range, threads, cacheMode);
+            const auto batchDuration = ranges::max(threadTimes);
+            if (batchDuration >= minBatchDuration || iterations >= maxIterations) {
+                break;
+            }
+
+            const double factor = batchDuration.count() > 0
+                                      ? 1.4 * static_cast<double>(minBatchDuration.count()) /
+                                            static_cast<double>(batchDuration.count())
+                                      : 10.0;
+            const auto nextIterations = static_cast<double>(iterations) * clamp(factor, 2.0, 10.0);
+            iterations = min(maxIterations, static_cast<int64_t>(nextIterations));
+        }
+
+        result.iterationsPerBatch = iterations;
+        if (options_.recordLatencies) {
+            result.latencies.emplace();
+        }
+
+        const auto numberOfBatches = max(1, options_.numberOfBatches);
+        chrono::nanoseconds measuredDuration{0};
+        for (int batch = 0; batch < numberOfBatches; ++batch) {
+            auto *latencies = result.latencies ? &*result.latencies : nullptr;
+            auto *perfCounters = framework_.isPerfCountersEnabled() ? &result.perfCounters : nullptr;
+            const auto threadTimes =
+                runBatch(iterations, range, threads, cacheMode, latencies, &result.counters, perfCounters);
+            const auto totalTime = accumulate(threadTimes.begin(), threadTimes.end(), chrono::nanoseconds{});
+            const auto batchDuration = ranges::max(threadTimes);
+            measuredDuration += batchDuration;
+
+            // The threads start together, so the longest thread gives the duration of the batch.
+            result.nanosecondsPerIteration.push_back(static_cast<double>(totalTime.count()) /
+                                                     static_cast<double>(iterations * threads));
+            if (batchDuration.count() > 0) {
+                result.iterationsPerSecond += 1e9 * static_cast<double>(iterations * threads) /
+                                              static_cast<double>(batchDuration.count()) / numberOfBatches;
+            }
+        }
+
+        result.computeStatistics();
+        // Rates are aggregated over the threads, like iterationsPerSecond.
+        result.counters.resolve(measuredDuration, iterations * threads * numberOfBatches);
+    } catch (const std::exception &exception) {
+        result.error = string{typeid(exception).name()} + "(" + exception.what() + ")";
+    }
+}
+
+vector<chrono::nanoseconds> BenchmarkBase::runBatch(int64_t iterations, int64_t range, int threads,
+                                                    CacheMode cacheMode, LatencyHistogram *latencies,
+                                                    UserCounters *counters,
+                                                    optional<PerfCounterValues> *perfCounters) {
+    barrier<> startBarrier{threads};
+    vector<BenchmarkState> states;
+    states.reserve(static_cast<size_t>(threads));
+    for (int i = 0; i < threads; ++i) {
+        auto *sharedBarrier = threads > 1 ? &startBarrier : nullptr;
+        states.push_back(BenchmarkState{iterations, range, i, threads, sharedBarrier});
+    }
+
+    // Each thread records into its own histogram, they are merged when the batch is done.
+    using Clock = BenchmarkState::Clock;
+    const auto timerOverhead = chrono::duration_cast<Clock::duration>(framework_.getTimerOverhead());
+    vector<LatencyHistogram> threadLatencies(latencies != nullptr ? states.size() : 0);
+    for (size_t i = 0; i < threadLatencies.size(); ++i) {
+        states[i].latencyHistogram_ = &threadLatencies[i];
+        states[i].timerOverhead_ = timerOverhead;
+    }
+    if (cacheMode != CacheMode::Warm) {
+        const auto &cacheFlusher = framework_.getCacheFlusher();
+        for (auto &state : states) {
+            state.cacheFlusher_ = &cacheFlusher;
+            state.cacheMode_ = cacheMode;
+            state.timerOverhead_ = timerOverhead;
+        }
+    }
+
+    // The counters only count the thread which opened them, so each thread opens its own group once and
+    // the calling thread reuses it for all its batches. The state enables the group only while measuring.
+    vector<optional<PerfCounterValues>> threadPerfCounters(perfCounters != nullptr ? states.size() : 0);
+    const auto runBody = [&](size_t i) {
+        if (!threadPerfCounters.empty()) {
+            thread_local PerfCounters threadCounters;
+            if (threadCounters.isAvailable()) {
+                states[i].perfCounters_ = &threadCounters;
+            }
+        }
+
+        benchmarkBody(states[i]);
+        if (states[i].perfCounters_ != nullptr && states[i].isFinished_) {
+            threadPerfCounters[i] = states[i].perfCounters_->read();
+        }
+    };
+
+    setUp(states.front());
+
+    if (threads == 1) {
+        runBody(0);
+    } else {
+        vector<exception_ptr> exceptions(states.size());
+        {
+            vector<jthread> workers;
+            for (size_t i = 0; i < states.size(); ++i) {
+                workers.emplace_back([&, i] {
+                    const auto &cpus = framework_.getCpuAffinity();
+                    if (!cpus.empty() && !pinCurrentThread(cpus[i % cpus.size()])) {
+                        framework_.isThreadPinningFailed_ = true;
+                    }
+
+                    try {
+                        runBody(i);
+                    } catch (...) {
+                        exceptions[i] = current_exception();
+                    }
+
+                    // Do not let the other threads wait for a thread which never started its measurement.
+                    if (!states[i].isStarted_) {
+                        startBarrier.arrive_and_drop();
+                    }
+                });
+            }
+        }
+
+        for (const auto &exception : exceptions) {
+            if (exception) {
+                rethrow_exception(exception);
+            }
+        }
+    }
+
+    tearDown(states.front());
+
+    for (const auto &threadLatency : threadLatencies) {
+        latencies->merge(threadLatency);
+    }
+    for (const auto &values : threadPerfCounters) {
+        if (values) {
+            if (!*perfCounters) {
+                perfCounters->emplace();
+            }
+            **perfCounters += *values;
+        }
+    }
+
+    vector<chrono::nanoseconds> measuredTimes;
+    for (const auto &state : states) {
+        if (!state.isFinished_) {
+            throw logic_error("The benchmark body did not run the keepRunning() loop to completion.");
+        }
+        if (counters != nullptr) {
+            counters->merge(state.counters_);
+        }
+
+        const auto overhead = framework_.getTimerOverhead() * state.numberOfMeasuredRegions_;
+        const auto measuredTime = chrono::duration_cast<chrono::nanoseconds>(state.measuredTime_);
+        measuredTimes.push_back(max(chrono::nanoseconds::zero(), measuredTime - overhead));
+    }
+
+    return measuredTimes;
+}
+
+} // namespace gtest
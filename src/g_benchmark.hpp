@@ -0,0 +1,583 @@
+/**
+ * @file g_benchmark.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Micro benchmarks registered with the GBENCH macro.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "g_benchmark_environment.hpp"
+#include "g_cache_flusher.hpp"
+#include "g_latency_histogram.hpp"
+#include "g_perf_counters.hpp"
+#include "g_user_counters.hpp"
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Prevents the compiler from optimizing away the computation of a value which is otherwise unused
+ * by the benchmark.
+ */
+template <typename Type> inline void doNotOptimize(const Type &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Complexity classes that the measured times of a range benchmark can be fitted to.
+ */
+enum class Complexity { None, O1, OLogN, ON, ONLogN, ON2, Auto };
+
+std::ostream &operator<<(std::ostream &os, Complexity complexity);
+
+/**
+ * @brief The state of the CPU caches each iteration of a benchmark starts with, see CacheFlusher.
+ */
+enum class CacheMode {
+    Warm,    ///< The caches hold whatever the previous iteration left in them.
+    Cold,    ///< The caches and the TLB are flushed before each iteration.
+    ColdTlb, ///< Only the TLB is flushed before each iteration.
+};
+
+std::ostream &operator<<(std::ostream &os, CacheMode cacheMode);
+
+/**
+ * @brief Options of a benchmark, given to the GBENCH macro with designated initializers.
+ */
+struct BenchmarkOptions {
+    /// The minimum duration of a batch. The number of iterations per batch is increased until it is reached.
+    std::chrono::nanoseconds minBatchDuration{std::chrono::milliseconds{10}};
+
+    /// The number of measured batches the statistics are computed from.
+    int numberOfBatches{10};
+
+    /// The first range argument, see BenchmarkState::getRange(). The benchmark is executed for the range
+    /// arguments rangeBegin, rangeBegin * rangeMultiplier, ... up to and including rangeEnd. Without a
+    /// range (rangeEnd == 0) the benchmark is executed once with range argument 0.
+    std::int64_t rangeBegin{1};
+
+    /// The last range argument.
+    std::int64_t rangeEnd{0};
+
+    /// The factor between consecutive range arguments.
+    std::int64_t rangeMultiplier{8};
+
+    /// The expected complexity of the benchmark as a function of the range argument. Auto reports the
+    /// best fitting complexity, an explicit complexity is also reported as a regression if a higher
+    /// complexity fits better. Fitting needs at least three range arguments.
+    Complexity complexity{Complexity::Auto};
+
+    /// The smallest number of threads executing the benchmark body concurrently. The benchmark is executed
+    /// for minThreads, 2 * minThreads, ... up to and including maxThreads threads.
+    int minThreads{1};
+
+    /// The largest number of threads executing the benchmark body concurrently.
+    int maxThreads{1};
+
+    /// Records the latency of every iteration in a histogram to report percentiles. Each iteration then
+    /// costs one extra clock read, which is subtracted from the recorded latency.
+    bool recordLatencies{false};
+
+    /// The state of the caches each iteration starts with. With Cold and ColdTlb each iteration is measured
+    /// separately after a flush, which takes up to milliseconds, so the number of iterations per batch is
+    /// limited by maxColdIterations.
+    CacheMode cacheMode{CacheMode::Warm};
+
+    /// Measures the benchmark also with warm caches when the cache mode is Cold or ColdTlb, so that the
+    /// warm and cold results are reported side by side.
+    bool compareWithWarm{false};
+
+    /// The maximum number of iterations per batch with cold caches.
+    std::int64_t maxColdIterations{100};
+};
+
+/**
+ * @brief The result of fitting measured times to a complexity, time = coefficient * f(n).
+ */
+struct ComplexityFit {
+    Complexity complexity{Complexity::None};
+    double coefficient{0.0};
+    double rms{0.0}; // Root mean square error relative to the mean time.
+};
+
+/**
+ * @brief Fits measured times to a complexity with least squares.
+ *
+ * @param ranges The range arguments, n.
+ * @param nanoseconds The measured time for each range argument.
+ * @param complexity The complexity to fit to, or Auto for the one with the smallest error.
+ */
+ComplexityFit fitComplexity(std::span<const std::int64_t> ranges, std::span<const double> nanoseconds,
+                            Complexity complexity);
+
+/**
+ * @brief Controls the iterations of a benchmark and which parts of them are measured.
+ *
+ * The measured region starts at the first call of keepRunning() and ends when it returns false, so
+ * anything done before the loop is not measured. Per iteration work which shall not be measured is
+ * enclosed in pauseTiming()/resumeTiming().
+ */
+class BenchmarkState {
+  public:
+    /**
+     * @brief Tells if another iteration shall be executed.
+     */
+    bool keepRunning() {
+        if (remainingIterations_ > 0) [[likely]] {
+            --remainingIterations_;
+            return true;
+        }
+        return startOrStopTiming();
+    }
+
+    /**
+     * @brief Stops measuring until resumeTiming() is called.
+     */
+    void pauseTiming();
+
+    /**
+     * @brief Continues measuring after pauseTiming().
+     */
+    void resumeTiming();
+
+    /**
+     * @brief Get the number of iterations of the current batch.
+     */
+    std::int64_t getIterations() const { return iterations_; }
+
+    /**
+     * @brief Get the range argument, e.g. the input size, the benchmark is executed with.
+     */
+    std::int64_t getRange() const { return range_; }
+
+    /**
+     * @brief Get the index of the thread executing the benchmark body, in [0, getNumberOfThreads()).
+     */
+    int getThreadIndex() const { return threadIndex_; }
+
+    /**
+     * @brief Get the number of threads executing the benchmark body concurrently.
+     */
+    int getNumberOfThreads() const { return numberOfThreads_; }
+
+    /**
+     * @brief Adds a value to a named counter which is reported with the result of the benchmark, e.g.
+     * addCounter("bytes", getIterations() * size, CounterKind::Rate) to report the bytes processed per
+     * second. The values added by all threads and measured batches are summed, and averages are per
+     * iteration. Each thread adds to the counters of its own state, so no synchronization is needed.
+     */
+    void addCounter(std::string_view name, double value, CounterKind kind = CounterKind::Total) {
+        counters_.add(name, value, kind);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    BenchmarkState(std::int64_t iterations, std::int64_t range, int threadIndex = 0, int numberOfThreads = 1,
+                   std::barrier<> *startBarrier = nullptr)
+        : iterations_{iterations}, range_{range}, threadIndex_{threadIndex},
+          numberOfThreads_{numberOfThreads}, startBarrier_{startBarrier} {}
+
+    bool startOrStopTiming();
+
+    /**
+     * @brief Ends the iteration which ended now, when iterations are measured separately. Its latency is
+     * recorded in latency recording mode.
+     */
+    void endIteration();
+
+    /**
+     * @brief Flushes the caches before an iteration in cold cache mode.
+     */
+    void flushCaches() const;
+
+    friend class BenchmarkBase;
+
+    std::int64_t iterations_;
+    std::int64_t range_;
+    int threadIndex_;
+    int numberOfThreads_;
+    std::barrier<> *startBarrier_; // Makes the threads start their measured regions together.
+    std::int64_t remainingIterations_ = 0;
+    bool isStarted_ = false;
+    bool isFinished_ = false;
+    bool isPaused_ = false;
+    Clock::time_point startTime_;
+    Clock::duration measuredTime_{};
+    std::int64_t numberOfMeasuredRegions_ = 0;
+    UserCounters counters_;
+    PerfCounters *perfCounters_ = nullptr; // Counts exactly the measured regions, like the timer.
+
+    // Latency recording and cold cache modes, where every call of keepRunning() takes the slow path.
+    LatencyHistogram *latencyHistogram_ = nullptr;
+    const CacheFlusher *cacheFlusher_ = nullptr;
+    CacheMode cacheMode_ = CacheMode::Warm;
+    std::int64_t remainingSeparateIterations_ = 0;
+    Clock::duration iterationTime_{};
+    std::int64_t iterationRegions_ = 0;
+    Clock::duration timerOverhead_{};
+};
+
+/**
+ * @brief Holds the measurements of a benchmark for one range argument and number of threads.
+ */
+struct BenchmarkResult {
+    std::string_view benchmarkName;
+    std::optional<std::int64_t> range;  // Empty for benchmarks without a range.
+    std::optional<int> threads;         // Empty for benchmarks which are not multithreaded.
+    std::optional<CacheMode> cacheMode; // Empty for benchmarks which are only measured with warm caches.
+    std::int64_t iterationsPerBatch{0};          // Per thread.
+    std::vector<double> nanosecondsPerIteration; // One sample per batch, averaged over the threads.
+    double iterationsPerSecond{0.0};             // Aggregated over all threads.
+    std::optional<LatencyHistogram> latencies;   // Only with BenchmarkOptions::recordLatencies.
+    UserCounters counters;                       // Added by the measured batches of all threads.
+    std::optional<PerfCounterValues> perfCounters; // Sum of the measured batches of all threads, if enabled.
+    double mean{0.0};
+    double median{0.0};
+    double standardDeviation{0.0};
+    double minimum{0.0};
+    std::optional<std::string> error;
+
+    /**
+     * @brief Computes the statistics from the samples.
+     */
+    void computeStatistics();
+
+    /**
+     * @brief Gives the name of the benchmark followed by the range argument, the number of threads and the
+     * cache mode, e.g. "Sort/512/threads:4/cold".
+     */
+    std::string getDisplayName() const;
+};
+
+class BenchmarkBase;
+
+/**
+ * @brief Holds the registered benchmarks and executes them. The results are sent to cout.
+ */
+class BenchmarkFramework {
+  public:
+    /**
+     * @brief Gives a reference to the singleton instance of the benchmark framework.
+     */
+    static BenchmarkFramework &getInstance() {
+        static BenchmarkFramework instance;
+        return instance;
+    }
+
+    /**
+     * @brief Registers a benchmark which will be executed when executeBenchmarks() is invoked. The
+     * benchmark is linked into an intrusive list, so no memory is allocated.
+     */
+    void registerBenchmark(BenchmarkBase &benchmark);
+
+    /**
+     * @brief Executes the registered benchmarks.
+     */
+    void executeBenchmarks();
+
+    /**
+     * @brief Executes the registered benchmarks whose names match the filter, see
+     * TestFramework::executeTests(filter).
+     */
+    void executeBenchmarks(std::string_view filter);
+
+    /**
+     * @brief Executes the registered benchmarks with options given on the command line:
+     *
+     * --filter=<patterns> Only execute the benchmarks matching the patterns.
+     * --cpus=<list>       Pin the benchmark threads to CPUs, e.g. "2,3" or "4-7", see setCpuAffinity().
+     * --high-priority     Raise the scheduling priority of the process.
+     * --results-json=<f>  Write the results to a file, one JSON object per line, see setResultsJsonFile().
+     * --results-csv=<f>   Write the results to a CSV file, see setResultsCsvFile().
+     *
+     * @param argc The number of arguments as given to main().
+     * @param argv The arguments as given to main().
+     */
+    void executeBenchmarks(int argc, char *argv[]);
+
+    /**
+     * @brief Gives the time measured for an empty region, i.e. the cost of reading the clock, which is
+     * subtracted from each measured region. It is calibrated at the first call.
+     */
+    std::chrono::nanoseconds getTimerOverhead();
+
+    /**
+     * @brief Pins the benchmark threads to CPUs. The calling thread, which executes single threaded
+     * benchmarks, is pinned to the first CPU and thread i of a multithreaded benchmark to
+     * cpus[i % cpus.size()]. An empty list disables pinning.
+     */
+    void setCpuAffinity(const std::vector<int> &cpus) { cpuAffinity_ = cpus; }
+
+    const std::vector<int> &getCpuAffinity() const { return cpuAffinity_; }
+
+    /**
+     * @brief Enables collection of hardware performance counters in the measured batches, counted by each
+     * thread of the batch. Like the timer they only count the measured regions, not the code before the
+     * keepRunning() loop, paused regions or cache flushes. If the counters are not available on the system
+     * the benchmarks are executed without them.
+     */
+    void enablePerfCounters(bool enable = true) { isPerfCountersEnabled_ = enable; }
+
+    bool isPerfCountersEnabled() const { return isPerfCountersEnabled_; }
+
+    /**
+     * @brief Makes executeBenchmarks() raise the scheduling priority of the process, which usually requires
+     * elevated permissions.
+     */
+    void setHighPriority(bool highPriority) { highPriority_ = highPriority; }
+
+    /**
+     * @brief Sets a file where the results are written as one JSON object per line, see
+     * BenchmarkResultWriter. An empty path disables the file.
+     */
+    void setResultsJsonFile(const std::filesystem::path &path) { resultsJsonFile_ = path; }
+
+    /**
+     * @brief Sets a CSV file where the results are written, see BenchmarkResultWriter. An empty path
+     * disables the file.
+     */
+    void setResultsCsvFile(const std::filesystem::path &path) { resultsCsvFile_ = path; }
+
+    /**
+     * @brief Get the environment the benchmarks were last executed in.
+     */
+    const BenchmarkEnvironment &getEnvironment() const { return environment_; }
+
+    /**
+     * @brief Gives the cache flusher used in cold cache mode. It is allocated at the first call.
+     */
+    const CacheFlusher &getCacheFlusher();
+
+  private:
+    friend class BenchmarkBase;
+
+    BenchmarkFramework() {}
+    BenchmarkFramework(const BenchmarkFramework &) = delete;
+
+    /**
+     * @brief Prints the environment and its warnings.
+     *
+     * @param unavailableCpus The CPUs of the affinity which were not available before the calling thread
+     * was pinned, see isCpuAvailable().
+     */
+    void printEnvironment(const std::vector<int> &unavailableCpus) const;
+
+    BenchmarkBase *firstBenchmark_ = nullptr;
+    BenchmarkBase *lastBenchmark_ = nullptr;
+    std::optional<std::chrono::nanoseconds> timerOverhead_;
+    std::vector<int> cpuAffinity_;
+    bool highPriority_ = false;
+    bool isPerfCountersEnabled_ = false;
+    std::atomic<bool> isThreadPinningFailed_ = false; // Set by the threads of multithreaded benchmarks.
+    BenchmarkEnvironment environment_;
+    std::filesystem::path resultsJsonFile_;
+    std::filesystem::path resultsCsvFile_;
+    std::unique_ptr<CacheFlusher> cacheFlusher_;
+};
+
+/**
+ * @brief The base class for benchmarks.
+ *
+ * A benchmark is executed in batches. The number of iterations per batch is first increased until a batch
+ * lasts at least BenchmarkOptions::minBatchDuration, then BenchmarkOptions::numberOfBatches batches are
+ * measured. Measuring batches instead of single iterations keeps the cost of reading the clock small
+ * compared to nanosecond scale iterations, and the calibrated cost of each measured region is subtracted.
+ *
+ * With more than one thread, each thread executes benchmarkBody() with its own BenchmarkState and the
+ * same number of iterations, while setUp() and tearDown() are called once per batch by the calling thread.
+ */
+class BenchmarkBase {
+  public:
+    /**
+     * @brief Construct a new BenchmarkBase object and registers it in the benchmark framework.
+     *
+     * @param benchmarkName The name of the benchmark. It is not copied, so only string literals such as the
+     * one given by the GBENCH macro are accepted, as they outlive the benchmark.
+     * @param fw A reference to the benchmark framework.
+     * @param options The options of the benchmark.
+     * @param location Where the benchmark is defined.
+     */
+    template <std::size_t N>
+    BenchmarkBase(const char (&benchmarkName)[N], BenchmarkFramework &fw,
+                  const BenchmarkOptions &options = {},
+                  std::source_location location = std::source_location::current())
+        : framework_{fw}, benchmarkName_{std::string_view{benchmarkName}}, options_{options},
+          location_{location} {
+        framework_.registerBenchmark(*this);
+    }
+
+    virtual ~BenchmarkBase() = default;
+
+    /**
+     * @brief Measures the benchmark.
+     */
+    void execute();
+
+    /**
+     * @brief Called before each batch, outside the measured region.
+     */
+    virtual void setUp(BenchmarkState &) {}
+
+    /**
+     * @brief Called after each batch, outside the measured region.
+     */
+    virtual void tearDown(BenchmarkState &) {}
+
+    /**
+     * @brief Defines what the benchmark measures. It must run the keepRunning() loop of the state to
+     * completion.
+     */
+    virtual void benchmarkBody(BenchmarkState &state) = 0;
+
+    std::string_view getBenchmarkName() const { return benchmarkName_; }
+
+    const std::source_location &getLocation() const { return location_; }
+
+    const BenchmarkOptions &getOptions() const { return options_; }
+
+    /**
+     * @brief Get the results, one for each range argument, cache mode and number of threads.
+     */
+    const std::vector<BenchmarkResult> &getResults() const { return results_; }
+
+    /**
+     * @brief Get the complexity fitted to the results, if any.
+     */
+    const std::optional<ComplexityFit> &getComplexityFit() const { return complexityFit_; }
+
+    /**
+     * @brief Gives the range arguments the benchmark is executed with.
+     */
+    std::vector<std::int64_t> getRanges() const;
+
+    /**
+     * @brief Gives the numbers of threads the benchmark is executed with.
+     */
+    std::vector<int> getThreadCounts() const;
+
+    /**
+     * @brief Gives the cache modes the benchmark is executed with.
+     */
+    std::vector<CacheMode> getCacheModes() const;
+
+  private:
+    BenchmarkBase(const BenchmarkBase &) = delete;
+
+    /**
+     * @brief Measures the benchmark for one range argument.
+     */
+    void measure(BenchmarkResult &result);
+
+    /**
+     * @brief Executes one batch on the given number of threads and gives the measured time of each thread
+     * with the timer overhead subtracted.
+     *
+     * @param latencies If not nullptr, the latency of each iteration is recorded and added to it.
+     * @param counters If not nullptr, the counters added by the threads are merged into it.
+     * @param perfCounters If not nullptr, the hardware performance counters of the threads are added to it.
+     */
+    std::vector<std::chrono::nanoseconds> runBatch(std::int64_t iterations, std::int64_t range, int threads,
+                                                   CacheMode cacheMode, LatencyHistogram *latencies = nullptr,
+                                                   UserCounters *counters = nullptr,
+                                                   std::optional<PerfCounterValues> *perfCounters = nullptr);
+
+    friend class BenchmarkFramework;
+
+    BenchmarkFramework &framework_;
+    std::string_view benchmarkName_;
+    BenchmarkOptions options_;
+    std::source_location location_;
+    BenchmarkBase *nextBenchmark_ = nullptr;
+    std::vector<BenchmarkResult> results_;
+    std::optional<ComplexityFit> complexityFit_;
+};
+
+/**
+ * @brief Base class for fixtures used with GBENCH_F. A fixture overrides setUp() and tearDown() to prepare
+ * state outside the measured region, and its members are accessible from the benchmark body.
+ */
+class BenchmarkFixture {
+  public:
+    void setUp(BenchmarkState &) {}
+    void tearDown(BenchmarkState &) {}
+};
+
+} // namespace gtest
+
+/**
+ * @brief Defines and registers a benchmark. Options may follow the name as designated initializers of
+ * BenchmarkOptions.
+ *
+ * Example usage:
+ * @code
+ * GBENCH(SortVector, .rangeBegin = 8, .rangeEnd = 1 << 20, .complexity = gtest::Complexity::ONLogN) {
+ *     std::vector<int> data(state.getRange());
+ *
+ *     while (state.keepRunning()) {
+ *         state.pauseTiming();
+ *         std::ranges::generate(data, std::rand);
+ *         state.resumeTiming();
+ *
+ *         std::ranges::sort(data);
+ *         gtest::doNotOptimize(data);
+ *     }
+ * }
+ * @endcode
+ */
+#define GBENCH(BenchmarkName, ...)                                                                           \
+    class BenchmarkName##Benchmark : public gtest::BenchmarkBase {                                           \
+      public:                                                                                                \
+        BenchmarkName##Benchmark(const char (&n)[sizeof(#BenchmarkName)], gtest::BenchmarkFramework &fw)     \
+            : BenchmarkBase{n, fw, gtest::BenchmarkOptions{__VA_ARGS__}} {}                                  \
+                                                                                                             \
+        void benchmarkBody(gtest::BenchmarkState &state) override;                                           \
+    };                                                                                                       \
+                                                                                                             \
+    static BenchmarkName##Benchmark BenchmarkName##BenchmarkInstance(                                        \
+        #BenchmarkName, gtest::BenchmarkFramework::getInstance());                                           \
+                                                                                                             \
+    void BenchmarkName##Benchmark::benchmarkBody([[maybe_unused]] gtest::BenchmarkState &state)
+
+/**
+ * @brief Defines and registers a benchmark using a fixture derived from gtest::BenchmarkFixture. The
+ * setUp() and tearDown() of the fixture are called around each batch.
+ */
+#define GBENCH_F(FixtureName, BenchmarkName, ...)                                                            \
+    class BenchmarkName##Benchmark : public gtest::BenchmarkBase, public FixtureName {                       \
+      public:                                                                                                \
+        BenchmarkName##Benchmark(const char (&n)[sizeof(#BenchmarkName)], gtest::BenchmarkFramework &fw)     \
+            : BenchmarkBase{n, fw, gtest::BenchmarkOptions{__VA_ARGS__}} {}                                  \
+                                                                                                             \
+        void setUp(gtest::BenchmarkState &state) override { FixtureName::setUp(state); }                     \
+        void tearDown(gtest::BenchmarkState &state) override { FixtureName::tearDown(state); }               \
+        void benchmarkBody(gtest::BenchmarkState &state) override;                                           \
+    };                                                                                                       \
+                                                                                                             \
+    static BenchmarkName##Benchmark BenchmarkName##BenchmarkInstance(                                        \
+        #BenchmarkName, gtest::BenchmarkFramework::getInstance());                                           \
+                                                                                                             \
+    void BenchmarkName##Benchmark::benchmarkBody([[maybe_unused]] gtest::BenchmarkState &state)
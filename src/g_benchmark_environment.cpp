@@ -0,0 +1,287 @@
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#include "g_benchmark_environment.hpp"
+#include "g_sanitizers.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr double MaxQuietLoadAverage{1.0};
+
+#if defined(__linux__)
+constexpr int HighPriorityNiceValue{-10};
+
+optional<string> readFirstLine(const string &path) {
+    ifstream file(path);
+    string line;
+    if (!file || !getline(file, line)) {
+        return nullopt;
+    }
+    return line;
+}
+
+string readCpuModel() {
+    ifstream cpuInfo("/proc/cpuinfo");
+    string line;
+    while (getline(cpuInfo, line)) {
+        if (line.starts_with("model name")) {
+            const auto valueStart = line.find_first_not_of(' ', line.find(':') + 1);
+            return valueStart == string::npos ? string{} : line.substr(valueStart);
+        }
+    }
+    return {};
+}
+
+optional<string> readGovernor(unsigned numberOfCores) {
+    optional<string> governor;
+    for (unsigned cpu = 0; cpu < numberOfCores; ++cpu) {
+        const auto coreGovernor =
+            readFirstLine("/sys/devices/system/cpu/cpu" + to_string(cpu) + "/cpufreq/scaling_governor");
+        if (!coreGovernor) {
+            continue;
+        }
+        if (governor && *governor != *coreGovernor) {
+            return "mixed";
+        }
+        governor = coreGovernor;
+    }
+    return governor;
+}
+
+/**
+ * @brief Reads the size of the highest level cache of the first CPU, e.g. "32768K".
+ */
+optional<size_t> readLastLevelCacheSize() {
+    optional<size_t> cacheSize;
+    int lastLevel{0};
+
+    for (int index = 0;; ++index) {
+        const auto directory = "/sys/devices/system/cpu/cpu0/cache/index" + to_string(index) + "/";
+        const auto level = readFirstLine(directory + "level");
+        const auto size = readFirstLine(directory + "size");
+        if (!level || !size) {
+            break;
+        }
+
+        size_t value{0};
+        const auto [end, error] = from_chars(size->data(), size->data() + size->size(), value);
+        if (error != errc{}) {
+            continue;
+        }
+        const auto unit = string_view{end, size->data() + size->size()};
+        value *= unit == "K" ? 1024 : unit == "M" ? 1024 * 1024 : unit == "G" ? 1024 * 1024 * 1024 : 1;
+
+        if (const auto cacheLevel = atoi(level->c_str()); cacheLevel >= lastLevel) {
+            lastLevel = cacheLevel;
+            cacheSize = value;
+        }
+    }
+
+    return cacheSize;
+}
+
+cpu_set_t toCpuSet(const vector<int> &cpus) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    return cpuSet;
+}
+#endif
+
+} // namespace
+
+BenchmarkEnvironment BenchmarkEnvironment::detect() {
+    BenchmarkEnvironment environment;
+    environment.numberOfCores = thread::hardware_concurrency();
+
+#if defined(__linux__)
+    environment.cpuModel = readCpuModel();
+    environment.governor = readGovernor(environment.numberOfCores);
+    environment.lastLevelCacheSize = readLastLevelCacheSize();
+
+    double loadAverage{0.0};
+    if (getloadavg(&loadAverage, 1) == 1) {
+        environment.loadAverage = loadAverage;
+    }
+#endif
+
+    return environment;
+}
+
+vector<string> BenchmarkEnvironment::getWarnings() const {
+    vector<string> warnings;
+
+    if (governor && *governor != "performance") {
+        warnings.push_back("CPU frequency scaling governor is \"" + *governor +
+                           "\", use \"performance\" for stable results.");
+    }
+    if (loadAverage && *loadAverage > MaxQuietLoadAverage) {
+        stringstream warning;
+        warning << "System load average is " << fixed << setprecision(2) << *loadAverage
+                << ", other processes may disturb the results.";
+        warnings.push_back(warning.str());
+    }
+    if (const auto sanitizers = Sanitizers::getActiveNames(); !sanitizers.empty()) {
+        warnings.push_back("Running under sanitizers (" + sanitizers +
+                           "), the results include the overhead of the instrumentation.");
+    }
+
+    return warnings;
+}
+
+ostream &operator<<(ostream &os, const BenchmarkEnvironment &environment) {
+    os << "  CPU: " << (environment.cpuModel.empty() ? "unknown" : environment.cpuModel) << " ("
+       << environment.numberOfCores << " cores)\n";
+    os << "  Last level cache: ";
+    if (environment.lastLevelCacheSize) {
+        os << *environment.lastLevelCacheSize / 1024 << " KiB\n";
+    } else {
+        os << "unknown\n";
+    }
+    os << "  Governor: " << environment.governor.value_or("unknown") << '\n';
+    os << "  Load average: ";
+    if (environment.loadAverage) {
+        stringstream loadAverage;
+        loadAverage << fixed << setprecision(2) << *environment.loadAverage;
+        os << loadAverage.str() << '\n';
+    } else {
+        os << "unknown\n";
+    }
+
+    os << "  Pinned CPUs: ";
+    if (environment.pinnedCpus.empty()) {
+        os << "none";
+    }
+    const char *separator = "";
+    for (auto cpu : environment.pinnedCpus) {
+        os << separator << cpu;
+        separator = ",";
+    }
+    os << '\n';
+
+    os << "  Priority: " << (environment.isHighPriority ? "high" : "normal") << '\n';
+    return os;
+}
+
+bool isCpuAvailable(int cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        return CPU_ISSET(cpu, &cpuSet);
+    }
+#endif
+
+    const auto numberOfCores = thread::hardware_concurrency();
+    return numberOfCores == 0 || static_cast<unsigned>(cpu) < numberOfCores;
+}
+
+optional<vector<int>> parseCpuList(string_view list) {
+    const auto parseNumber = [](string_view text) -> optional<int> {
+        int value{0};
+        const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+        if (error != errc{} || end != text.data() + text.size() || value < 0) {
+            return nullopt;
+        }
+        return value;
+    };
+
+    vector<int> cpus;
+    for (const auto part : views::split(list, ',')) {
+        const string_view item{part.begin(), part.end()};
+        const auto dash = item.find('-');
+        const auto first = parseNumber(item.substr(0, dash));
+        const auto last = dash == string_view::npos ? first : parseNumber(item.substr(dash + 1));
+        if (!first || !last || *last < *first) {
+            return nullopt;
+        }
+        // Stops at the first unavailable CPU, so that a range such as 0-100000 is not expanded.
+        for (auto cpu = *first; cpu <= *last; ++cpu) {
+            if (!isCpuAvailable(cpu)) {
+                return nullopt;
+            }
+            cpus.push_back(cpu);
+        }
+    }
+
+    if (cpus.empty()) {
+        return nullopt;
+    }
+    return cpus;
+}
+
+bool pinCurrentThread([[maybe_unused]] int cpu) {
+#if defined(__linux__)
+    const auto cpuSet = toCpuSet({cpu});
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+ScopedCpuAffinity::ScopedCpuAffinity([[maybe_unused]] const vector<int> &cpus) {
+#if defined(__linux__)
+    cpu_set_t previousSet;
+    if (cpus.empty() || sched_getaffinity(0, sizeof(previousSet), &previousSet) != 0) {
+        return;
+    }
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &previousSet)) {
+            previousCpus_.push_back(cpu);
+        }
+    }
+
+    const auto cpuSet = toCpuSet(cpus);
+    isPinned_ = sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#endif
+}
+
+ScopedCpuAffinity::~ScopedCpuAffinity() {
+#if defined(__linux__)
+    if (!previousCpus_.empty()) {
+        const auto cpuSet = toCpuSet(previousCpus_);
+        sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+    }
+#endif
+}
+
+bool raiseProcessPriority() {
+#if defined(__linux__)
+    return setpriority(PRIO_PROCESS, 0, HighPriorityNiceValue) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace gtest
@@ -0,0 +1,100 @@
+/**
+ * @file g_benchmark_environment.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Detection and stabilization of the system benchmarks are executed on.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Describes the system benchmarks are executed on, so that results from different runs can be
+ * compared. Information which is not available on the system is left empty.
+ */
+struct BenchmarkEnvironment {
+    std::string cpuModel;
+    unsigned numberOfCores{0};
+    std::optional<std::size_t> lastLevelCacheSize; // In bytes.
+    std::optional<std::string> governor; // CPU frequency scaling governor, "mixed" if the cores differ.
+    std::optional<double> loadAverage;   // One minute load average when the benchmarks started.
+    std::vector<int> pinnedCpus;         // Empty if the benchmark threads are not pinned.
+    bool isHighPriority{false};
+
+    /**
+     * @brief Detects the environment of the current system.
+     */
+    static BenchmarkEnvironment detect();
+
+    /**
+     * @brief Gives warnings about conditions which make benchmark results noisy, e.g. a CPU frequency
+     * scaling governor other than "performance".
+     */
+    std::vector<std::string> getWarnings() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const BenchmarkEnvironment &environment);
+
+/**
+ * @brief Tells if the calling thread may run on a CPU, i.e. if the CPU is in its affinity mask. Where the
+ * mask is not available, tells if the CPU is below the number of cores.
+ */
+bool isCpuAvailable(int cpu);
+
+/**
+ * @brief Parses a list of CPUs such as "0,2,4-7".
+ *
+ * @return The CPUs, or empty if the list is not valid or contains a CPU which is not available, see
+ * isCpuAvailable().
+ */
+std::optional<std::vector<int>> parseCpuList(std::string_view list);
+
+/**
+ * @brief Pins the calling thread to a CPU.
+ *
+ * @return False if pinning is not supported or failed.
+ */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs and restores the previous affinity at destruction.
+ * Does nothing if the set is empty.
+ */
+class ScopedCpuAffinity {
+  public:
+    explicit ScopedCpuAffinity(const std::vector<int> &cpus);
+    ~ScopedCpuAffinity();
+
+    ScopedCpuAffinity(const ScopedCpuAffinity &) = delete;
+    ScopedCpuAffinity &operator=(const ScopedCpuAffinity &) = delete;
+
+    /**
+     * @brief Tells if the calling thread was restricted to the CPUs.
+     */
+    bool isPinned() const { return isPinned_; }
+
+  private:
+    std::vector<int> previousCpus_;
+    bool isPinned_{false};
+};
+
+/**
+ * @brief Raises the scheduling priority of the process.
+ *
+ * @return False if the priority could not be raised, e.g. because of missing permissions.
+ */
+bool raiseProcessPriority();
+
+} // namespace gtest
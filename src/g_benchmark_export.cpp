@@ -0,0 +1,237 @@
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "g_benchmark_export.hpp"
+#include "g_json.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+template <typename Type> void writeJsonOptional(ostream &os, const optional<Type> &value) {
+    if (value) {
+        os << *value;
+    } else {
+        os << "null";
+    }
+}
+
+template <typename Type> void writeCsvOptional(ostream &os, const optional<Type> &value) {
+    if (value) {
+        os << *value;
+    }
+}
+
+/**
+ * @brief Writes a CSV field, quoted if it contains a separator, quote or line break.
+ */
+void writeCsvString(ostream &os, string_view text) {
+    if (text.find_first_of(",\"\r\n") == string_view::npos) {
+        os << text;
+        return;
+    }
+
+    os << '"';
+    for (const char c : text) {
+        os << (c == '"' ? "\"\"" : string_view{&c, 1});
+    }
+    os << '"';
+}
+
+string currentUtcTime() {
+    const auto now = chrono::system_clock::to_time_t(chrono::system_clock::now());
+    stringstream text;
+    text << put_time(gmtime(&now), "%Y-%m-%dT%H:%M:%SZ");
+    return text.str();
+}
+
+} // namespace
+
+BenchmarkResultWriter::BenchmarkResultWriter(const filesystem::path &jsonFile,
+                                             const filesystem::path &csvFile) {
+    for (auto [stream, path] : {pair{&json_, &jsonFile}, pair{&csv_, &csvFile}}) {
+        if (path->empty()) {
+            continue;
+        }
+
+        stream->open(*path, ios::trunc);
+        if (!*stream) {
+            cerr << "Could not open benchmark results file " << path->string() << endl;
+        }
+        *stream << setprecision(numeric_limits<double>::digits10);
+    }
+}
+
+void BenchmarkResultWriter::writeHeader(const BenchmarkEnvironment &environment,
+                                        chrono::nanoseconds timerOverhead) {
+    if (json_.is_open()) {
+        json_ << "{\"type\":\"header\",\"schema\":\"gtest-benchmark\",\"version\":" << BenchmarkSchemaVersion
+              << ",\"date\":\"" << currentUtcTime() << "\",\"timerOverheadNs\":" << timerOverhead.count()
+              << ",\"environment\":{\"cpuModel\":";
+        writeJsonString(json_, environment.cpuModel);
+        json_ << ",\"numberOfCores\":" << environment.numberOfCores << ",\"lastLevelCacheBytes\":";
+        writeJsonOptional(json_, environment.lastLevelCacheSize);
+        json_ << ",\"governor\":";
+        if (environment.governor) {
+            writeJsonString(json_, *environment.governor);
+        } else {
+            json_ << "null";
+        }
+        json_ << ",\"loadAverage\":";
+        writeJsonOptional(json_, environment.loadAverage);
+        json_ << ",\"pinnedCpus\":[";
+        const char *separator = "";
+        for (auto cpu : environment.pinnedCpus) {
+            json_ << separator << cpu;
+            separator = ",";
+        }
+        json_ << "],\"highPriority\":" << (environment.isHighPriority ? "true" : "false") << "}}\n" << flush;
+    }
+
+    if (csv_.is_open()) {
+        csv_ << "schema_version,name,range,threads,iterations,batches,mean_ns,median_ns,stddev_ns,min_ns,"
+                "iterations_per_second,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,error,counters,cache_mode,"
+                "instructions,cycles,cache_misses,branch_misses\n"
+             << flush;
+    }
+}
+
+void BenchmarkResultWriter::writeResults(const BenchmarkBase &benchmark) {
+    for (const auto &result : benchmark.getResults()) {
+        if (json_.is_open()) {
+            writeJsonResult(result);
+        }
+        if (csv_.is_open()) {
+            writeCsvResult(result);
+        }
+    }
+
+    if (const auto &fit = benchmark.getComplexityFit(); fit && json_.is_open()) {
+        stringstream complexity;
+        complexity << fit->complexity;
+        stringstream expected;
+        expected << benchmark.getOptions().complexity;
+
+        json_ << "{\"type\":\"complexity\",\"name\":";
+        writeJsonString(json_, benchmark.getBenchmarkName());
+        json_ << ",\"complexity\":";
+        writeJsonString(json_, complexity.view());
+        json_ << ",\"expected\":";
+        writeJsonString(json_, expected.view());
+        json_ << ",\"coefficientNs\":" << fit->coefficient << ",\"rms\":" << fit->rms << "}\n";
+    }
+
+    json_ << flush;
+    csv_ << flush;
+}
+
+void BenchmarkResultWriter::writeJsonResult(const BenchmarkResult &result) {
+    json_ << "{\"type\":\"result\",\"name\":";
+    writeJsonString(json_, result.benchmarkName);
+    json_ << ",\"range\":";
+    writeJsonOptional(json_, result.range);
+    json_ << ",\"threads\":";
+    writeJsonOptional(json_, result.threads);
+    json_ << ",\"iterations\":" << result.iterationsPerBatch
+          << ",\"batches\":" << result.nanosecondsPerIteration.size() << ",\"meanNs\":" << result.mean
+          << ",\"medianNs\":" << result.median << ",\"stddevNs\":" << result.standardDeviation
+          << ",\"minNs\":" << result.minimum << ",\"iterationsPerSecond\":" << result.iterationsPerSecond
+          << ",\"latencyNs\":";
+
+    if (result.latencies) {
+        const auto &latencies = *result.latencies;
+        json_ << "{\"p50\":" << latencies.percentile(50.0) << ",\"p90\":" << latencies.percentile(90.0)
+              << ",\"p99\":" << latencies.percentile(99.0) << ",\"p999\":" << latencies.percentile(99.9)
+              << ",\"max\":" << latencies.getMax() << '}';
+    } else {
+        json_ << "null";
+    }
+
+    json_ << ",\"error\":";
+    if (result.error) {
+        writeJsonString(json_, *result.error);
+    } else {
+        json_ << "null";
+    }
+
+    json_ << ",\"counters\":[";
+    const char *separator = "";
+    for (const auto &counter : result.counters) {
+        json_ << separator << "{\"name\":";
+        writeJsonString(json_, counter.name);
+        json_ << ",\"kind\":\"" << counter.kind << "\",\"value\":" << counter.value << '}';
+        separator = ",";
+    }
+
+    json_ << "],\"cacheMode\":";
+    if (result.cacheMode) {
+        json_ << '"' << *result.cacheMode << '"';
+    } else {
+        json_ << "null";
+    }
+    json_ << ",\"perfCounters\":";
+    if (result.perfCounters) {
+        writePerfCountersJson(json_, *result.perfCounters);
+    } else {
+        json_ << "null";
+    }
+    json_ << "}\n";
+}
+
+void BenchmarkResultWriter::writeCsvResult(const BenchmarkResult &result) {
+    csv_ << BenchmarkSchemaVersion << ',';
+    writeCsvString(csv_, result.benchmarkName);
+    csv_ << ',';
+    writeCsvOptional(csv_, result.range);
+    csv_ << ',';
+    writeCsvOptional(csv_, result.threads);
+    csv_ << ',' << result.iterationsPerBatch << ',' << result.nanosecondsPerIteration.size() << ','
+         << result.mean << ',' << result.median << ',' << result.standardDeviation << ',' << result.minimum
+         << ',' << result.iterationsPerSecond << ',';
+
+    if (result.latencies) {
+        const auto &latencies = *result.latencies;
+        csv_ << latencies.percentile(50.0) << ',' << latencies.percentile(90.0) << ','
+             << latencies.percentile(99.0) << ',' << latencies.percentile(99.9) << ',' << latencies.getMax();
+    } else {
+        csv_ << ",,,,";
+    }
+
+    csv_ << ',';
+    if (result.error) {
+        writeCsvString(csv_, *result.error);
+    }
+
+    csv_ << ',';
+    stringstream counters;
+    counters << setprecision(numeric_limits<double>::digits10);
+    const char *separator = "";
+    for (const auto &counter : result.counters) {
+        counters << separator << counter.name << '=' << counter.value;
+        separator = ";";
+    }
+    writeCsvString(csv_, counters.view());
+    csv_ << ',';
+    writeCsvOptional(csv_, result.cacheMode);
+
+    const auto perfCounters = result.perfCounters.value_or(PerfCounterValues{});
+    for (const auto &value : {perfCounters.instructions, perfCounters.cycles, perfCounters.cacheMisses,
+                              perfCounters.branchMisses}) {
+        csv_ << ',';
+        writeCsvOptional(csv_, value);
+    }
+    csv_ << '\n';
+}
+
+} // namespace gtest
@@ -0,0 +1,68 @@
+/**
+ * @file g_benchmark_export.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Export of benchmark results to JSON Lines and CSV files.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "g_benchmark.hpp"
+#include "g_benchmark_environment.hpp"
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief The version of the schema of the exported benchmark results. It is incremented when fields are
+ * added or changed, fields are never removed or reordered.
+ */
+constexpr int BenchmarkSchemaVersion = 4;
+
+/**
+ * @brief Writes benchmark results to a JSON Lines file and/or a CSV file as the benchmarks complete, so
+ * that the files of a long benchmark run can be consumed before it is done.
+ *
+ * The JSON file starts with a "header" record holding the schema version and the environment, followed by
+ * one "result" record per range argument and number of threads, and a "complexity" record for each fitted
+ * benchmark. Each CSV row holds one result and starts with the schema version.
+ *
+ * Version 2 added the user counters, as a "counters" array of the result records and as a last CSV column
+ * with "name=value" pairs separated by ';'. Version 3 added the cache mode of the results and the size of the
+ * last level cache to the environment. Version 4 added the hardware performance counters of the measured
+ * batches, as a "perfCounters" object of the result records and as the CSV columns instructions, cycles,
+ * cache_misses and branch_misses, which are empty when the counters are not collected.
+ */
+class BenchmarkResultWriter {
+  public:
+    /**
+     * @brief Opens the files. An empty path disables the corresponding format.
+     */
+    BenchmarkResultWriter(const std::filesystem::path &jsonFile, const std::filesystem::path &csvFile);
+
+    /**
+     * @brief Writes the header record of the JSON file and the column names of the CSV file.
+     */
+    void writeHeader(const BenchmarkEnvironment &environment, std::chrono::nanoseconds timerOverhead);
+
+    /**
+     * @brief Writes the results of an executed benchmark and flushes the files.
+     */
+    void writeResults(const BenchmarkBase &benchmark);
+
+  private:
+    void writeJsonResult(const BenchmarkResult &result);
+    void writeCsvResult(const BenchmarkResult &result);
+
+    std::ofstream json_;
+    std::ofstream csv_;
+};
+
+} // namespace gtest
@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+
+#include "g_benchmark.hpp"
+#include "g_cache_flusher.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr size_t CacheLineSize{64};
+constexpr size_t PageSize{4096};
+
+// Covers 16384 pages, more than the second level TLB of current CPUs holds, and is used when the size of
+// the last level cache is not known.
+constexpr size_t MinBufferSize{64 * 1024 * 1024};
+
+unsigned readEvery(const vector<unsigned char> &buffer, size_t stride) {
+    unsigned sum{0};
+    for (size_t i = 0; i < buffer.size(); i += stride) {
+        sum += buffer[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+CacheFlusher::CacheFlusher(optional<size_t> lastLevelCacheSize)
+    : buffer_(max(MinBufferSize, 2 * lastLevelCacheSize.value_or(0)), 1) {}
+
+void CacheFlusher::flushCaches() const { doNotOptimize(readEvery(buffer_, CacheLineSize)); }
+
+void CacheFlusher::flushTlb() const { doNotOptimize(readEvery(buffer_, PageSize)); }
+
+} // namespace gtest
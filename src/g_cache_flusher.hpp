@@ -0,0 +1,54 @@
+/**
+ * @file g_cache_flusher.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Eviction of benchmark data from the CPU caches and TLB.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Evicts the data of a benchmark from the CPU caches and the TLB, so that the next iteration is
+ * measured with cold caches.
+ *
+ * The caches are flushed by reading one byte per cache line of a buffer twice the size of the last level
+ * cache, which also touches more pages than the TLB holds. Flushing only the TLB reads one byte per page
+ * of the buffer, which is much faster and leaves most of the caches intact. The buffer is only read, so
+ * the threads of a multithreaded benchmark may flush concurrently.
+ */
+class CacheFlusher {
+  public:
+    /**
+     * @brief Allocates the buffer.
+     *
+     * @param lastLevelCacheSize The size of the last level cache in bytes, if known.
+     */
+    explicit CacheFlusher(std::optional<std::size_t> lastLevelCacheSize);
+
+    /**
+     * @brief Evicts the caches and the TLB.
+     */
+    void flushCaches() const;
+
+    /**
+     * @brief Evicts the TLB.
+     */
+    void flushTlb() const;
+
+    std::size_t getBufferSize() const { return buffer_.size(); }
+
+  private:
+    std::vector<unsigned char> buffer_;
+};
+
+} // namespace gtest
@@ -0,0 +1,206 @@
+#include <array>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// MinGW has <unistd.h> but not sigaction(), so Windows is detected explicitly and falls back to signal().
+#if !defined(_WIN32) && __has_include(<unistd.h>)
+#include <signal.h>
+#include <unistd.h>
+#define GTEST_HAS_POSIX_SIGNALS 1
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+#include "g_check_trace.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr int StandardErrorFd{2};
+
+#if defined(GTEST_HAS_POSIX_SIGNALS)
+constexpr array<int, 5> CrashSignals{SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+#else
+constexpr array<int, 4> CrashSignals{SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+#endif
+
+#if defined(GTEST_HAS_POSIX_SIGNALS)
+// The handler runs on its own stack on the thread which installs it, so that a stack overflow of the main
+// thread can be reported.
+constexpr size_t AlternateStackSize{64 * 1024};
+alignas(16) char alternateStack[AlternateStackSize];
+
+array<struct sigaction, CrashSignals.size()> previousActions;
+#else
+using SignalHandler = void (*)(int);
+array<SignalHandler, CrashSignals.size()> previousHandlers;
+#endif
+
+/**
+ * @brief Unbuffered writer for the signal handler, which may neither allocate nor use streams.
+ */
+class SignalSafeWriter {
+  public:
+    explicit SignalSafeWriter(int fd) : fd_(fd) {}
+
+    SignalSafeWriter &operator<<(string_view text) {
+        while (!text.empty()) {
+#if defined(GTEST_HAS_POSIX_SIGNALS)
+            const auto written = ::write(fd_, text.data(), text.size());
+#else
+            const auto written = _write(fd_, text.data(), static_cast<unsigned>(text.size()));
+#endif
+            if (written <= 0) {
+                break;
+            }
+            text.remove_prefix(static_cast<size_t>(written));
+        }
+        return *this;
+    }
+
+    SignalSafeWriter &operator<<(const char *text) { return *this << string_view{text ? text : "?"}; }
+
+    SignalSafeWriter &operator<<(uint64_t value) {
+        array<char, 20> digits;
+        size_t first = digits.size();
+        do {
+            digits[--first] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        return *this << string_view{digits.data() + first, digits.size() - first};
+    }
+
+  private:
+    int fd_;
+};
+
+string_view signalName(int signal) {
+    switch (signal) {
+    case SIGSEGV:
+        return "SIGSEGV";
+    case SIGABRT:
+        return "SIGABRT";
+#if defined(SIGBUS)
+    case SIGBUS:
+        return "SIGBUS";
+#endif
+    case SIGFPE:
+        return "SIGFPE";
+    case SIGILL:
+        return "SIGILL";
+    default:
+        return "signal";
+    }
+}
+
+void writeCrashReport(int signal) {
+    SignalSafeWriter{StandardErrorFd} << "\n*** " << signalName(signal) << " received ***\n";
+    CheckTrace::writeTrace(StandardErrorFd);
+}
+
+#if defined(GTEST_HAS_POSIX_SIGNALS)
+
+void crashHandler(int signal, siginfo_t *info, void *) {
+    writeCrashReport(signal);
+
+    // Restore the previous handler, so that a sanitizer or the default action handles the crash.
+    for (size_t i = 0; i < CrashSignals.size(); ++i) {
+        if (CrashSignals[i] == signal) {
+            sigaction(signal, &previousActions[i], nullptr);
+        }
+    }
+
+    // A fault raised by the CPU is raised again when the handler returns and the instruction is retried,
+    // while a signal sent by abort() or kill() has to be raised again.
+    if (info == nullptr || info->si_code <= 0) {
+        raise(signal);
+    }
+}
+
+#else
+
+void crashHandler(int signal) {
+    writeCrashReport(signal);
+
+    for (size_t i = 0; i < CrashSignals.size(); ++i) {
+        if (CrashSignals[i] == signal) {
+            std::signal(signal, previousHandlers[i]);
+        }
+    }
+    raise(signal);
+}
+
+#endif
+
+} // namespace
+
+void CheckTrace::setCurrentTest(string_view testName) {
+    auto &buffer = threadBuffer_;
+    if (!testName.empty()) {
+        buffer.numberOfChecks = 0;
+    }
+    buffer.testName = testName;
+}
+
+void CheckTrace::installCrashHandler() {
+#if defined(GTEST_HAS_POSIX_SIGNALS)
+    static const bool isInstalled = [] {
+        stack_t stack{};
+        stack.ss_sp = alternateStack;
+        stack.ss_size = AlternateStackSize;
+        sigaltstack(&stack, nullptr);
+
+        struct sigaction action{};
+        action.sa_sigaction = crashHandler;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+
+        for (size_t i = 0; i < CrashSignals.size(); ++i) {
+            sigaction(CrashSignals[i], &action, &previousActions[i]);
+        }
+        return true;
+    }();
+    (void)isInstalled;
+#else
+    static const bool isInstalled = [] {
+        for (size_t i = 0; i < CrashSignals.size(); ++i) {
+            previousHandlers[i] = std::signal(CrashSignals[i], crashHandler);
+        }
+        return true;
+    }();
+    (void)isInstalled;
+#endif
+}
+
+void CheckTrace::writeTrace(int fd) {
+    const auto &buffer = threadBuffer_;
+    SignalSafeWriter writer{fd};
+
+    if (buffer.testName.empty()) {
+        writer << "No test case was being executed by the crashing thread.\n";
+    } else {
+        writer << "In test case " << buffer.testName << ".\n";
+    }
+
+    const auto numberOfChecks = buffer.numberOfChecks;
+    if (numberOfChecks == 0) {
+        writer << "No checks were made by the thread.\n";
+        return;
+    }
+
+    const auto numberOfEntries = numberOfChecks < Capacity ? numberOfChecks : uint64_t{Capacity};
+    writer << "The last " << numberOfEntries << " of " << numberOfChecks << " checks of the thread:\n";
+
+    for (auto i = numberOfChecks - numberOfEntries; i < numberOfChecks; ++i) {
+        const auto &entry = buffer.entries[i % Capacity];
+        writer << "  #" << static_cast<uint64_t>(entry.checkNumber) << " " << entry.file << ":"
+               << static_cast<uint64_t>(entry.line) << (entry.isFailed ? " FAILED\n" : " passed\n");
+    }
+}
+
+} // namespace gtest
@@ -0,0 +1,101 @@
+/**
+ * @file g_check_trace.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Trace of the last checks of each thread, written when the process crashes.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <source_location>
+#include <string_view>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Records the last checks made by each thread in a ring buffer, which a signal handler writes to
+ * stderr if the process crashes with SIGSEGV, SIGABRT, SIGBUS, SIGFPE or SIGILL. The results of a test
+ * case are only reported when its body returns, so the trace is the only context left of a test case
+ * which crashes in the middle of its body.
+ *
+ * Each thread writes to its own buffer and the signal handler runs on the crashing thread, so recording a
+ * check is a few stores without locks, atomic instructions or allocation.
+ */
+class CheckTrace {
+  public:
+    static constexpr std::size_t Capacity = 32;
+
+    /**
+     * @brief Records a check which is about to be made.
+     */
+    static void recordCheck(const std::source_location &location, int checkNumber) {
+        auto &buffer = threadBuffer_;
+        auto &entry = buffer.entries[buffer.numberOfChecks % Capacity];
+        entry.file = location.file_name();
+        entry.line = location.line();
+        entry.checkNumber = checkNumber;
+        entry.isFailed = false;
+
+        // The entry must be complete before it is counted, as seen by a signal handler on this thread.
+        std::atomic_signal_fence(std::memory_order_release);
+        ++buffer.numberOfChecks;
+    }
+
+    /**
+     * @brief Marks the last recorded check of the calling thread as failed.
+     */
+    static void markLastCheckFailed() {
+        auto &buffer = threadBuffer_;
+        if (buffer.numberOfChecks > 0) {
+            buffer.entries[(buffer.numberOfChecks - 1) % Capacity].isFailed = true;
+        }
+    }
+
+    /**
+     * @brief Sets the test case executed by the calling thread and clears its trace. An empty name tells
+     * that no test case is executed, the trace is then kept.
+     *
+     * @param testName The name of the test case. It is not copied and must outlive the test case.
+     */
+    static void setCurrentTest(std::string_view testName);
+
+    /**
+     * @brief Installs the signal handler which writes the trace of the crashing thread. The previous
+     * handlers are called afterwards, so sanitizers and debuggers still see the crash. Calling it more
+     * than once has no effect.
+     */
+    static void installCrashHandler();
+
+    /**
+     * @brief Writes the trace of the calling thread to a file descriptor, oldest check first. Only
+     * async-signal-safe functions are used.
+     */
+    static void writeTrace(int fd);
+
+  private:
+    struct Entry {
+        const char *file;
+        std::uint_least32_t line;
+        int checkNumber;
+        bool isFailed;
+    };
+
+    struct Buffer {
+        std::array<Entry, Capacity> entries;
+        std::uint64_t numberOfChecks;
+        std::string_view testName;
+    };
+
+    // Constant initialized, so that accessing it needs no guard and is safe in a signal handler.
+    static constinit inline thread_local Buffer threadBuffer_{};
+};
+
+} // namespace gtest
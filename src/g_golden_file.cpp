@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GTEST_HAS_MMAP 1
+#endif
+
+#include "g_golden_file.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr size_t DiffContextBytes = 8;
+
+void printHexBytes(ostream &os, span<const byte> bytes, size_t begin, size_t end) {
+    ios_base::fmtflags savedFlags(os.flags());
+
+    end = min(end, bytes.size());
+    os << hex << setfill('0');
+    for (auto i = begin; i < end; ++i) {
+        os << setw(2) << to_integer<int>(bytes[i]) << (i + 1 < end ? " " : "");
+    }
+
+    os.flags(savedFlags);
+}
+
+} // namespace
+
+MappedFile::MappedFile(const filesystem::path &path) {
+#if defined(GTEST_HAS_MMAP)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd != -1) {
+        struct stat fileStatus {};
+        if (fstat(fd, &fileStatus) == 0) {
+            size_ = static_cast<size_t>(fileStatus.st_size);
+            if (size_ == 0) {
+                isOpen_ = true;
+            } else if (void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                       mapping != MAP_FAILED) {
+                mapping_ = mapping;
+                data_ = static_cast<const byte *>(mapping);
+                isOpen_ = true;
+            }
+        }
+        close(fd);
+    }
+
+    if (isOpen_) {
+        return;
+    }
+#endif
+
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file) {
+        return;
+    }
+
+    buffer_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (file.read(reinterpret_cast<char *>(buffer_.data()), static_cast<streamsize>(buffer_.size()))) {
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        isOpen_ = true;
+    }
+}
+
+MappedFile::~MappedFile() {
+#if defined(GTEST_HAS_MMAP)
+    if (mapping_ != nullptr) {
+        munmap(mapping_, size_);
+    }
+#endif
+}
+
+optional<string> compareWithGoldenFile(const filesystem::path &path, span<const byte> bytes) {
+    const MappedFile golden(path);
+
+    if (!golden.isOpen()) {
+        return "Golden file " + path.string() + " not found (run with --update-golden to create it)";
+    }
+
+    const auto expected = golden.bytes();
+    const auto commonSize = min(bytes.size(), expected.size());
+
+    if (bytes.size() == expected.size() &&
+        (commonSize == 0 || memcmp(bytes.data(), expected.data(), commonSize) == 0)) {
+        return nullopt;
+    }
+
+    const auto mismatch = ranges::mismatch(bytes.first(commonSize), expected.first(commonSize));
+    const auto offset = static_cast<size_t>(mismatch.in1 - bytes.begin());
+    const auto contextBegin = offset > DiffContextBytes ? offset - DiffContextBytes : 0;
+    const auto contextEnd = offset + DiffContextBytes;
+
+    stringstream diff;
+    diff << "Differs from " << path.string() << " at offset " << offset << " | Size: " << bytes.size()
+         << " | Expected size: " << expected.size() << " | Result bytes " << contextBegin << ": ";
+    printHexBytes(diff, bytes, contextBegin, contextEnd);
+    diff << " | Expected bytes " << contextBegin << ": ";
+    printHexBytes(diff, expected, contextBegin, contextEnd);
+
+    return diff.str();
+}
+
+bool writeFileAtomically(const filesystem::path &path, span<const byte> bytes) {
+    error_code error;
+
+    if (path.has_parent_path()) {
+        filesystem::create_directories(path.parent_path(), error);
+    }
+
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        ofstream file(temporaryPath, ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<streamsize>(bytes.size()));
+        if (!file.flush()) {
+            return false;
+        }
+    }
+
+    filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace gtest
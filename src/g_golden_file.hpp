@@ -0,0 +1,71 @@
+/**
+ * @file g_golden_file.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Memory mapped golden files used by GCHECK_GOLDEN.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Read-only view of a file. The file is memory mapped where the platform supports it, otherwise
+ * it is read into memory.
+ */
+class MappedFile {
+  public:
+    /**
+     * @brief Maps the given file. Use isOpen() to see if it succeeded.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return isOpen_; }
+
+    /**
+     * @brief Gives the contents of the file.
+     */
+    std::span<const std::byte> bytes() const { return {data_, size_}; }
+
+  private:
+    bool isOpen_ = false;
+    const std::byte *data_ = nullptr;
+    std::size_t size_ = 0;
+    void *mapping_ = nullptr;
+    std::vector<std::byte> buffer_; // Only used when the file could not be mapped.
+};
+
+/**
+ * @brief Compares data with the contents of a golden file.
+ *
+ * @param path The golden file.
+ * @param bytes The data to compare.
+ * @return Empty if the data is equal to the golden file, otherwise a description of the difference.
+ */
+std::optional<std::string> compareWithGoldenFile(const std::filesystem::path &path,
+                                                 std::span<const std::byte> bytes);
+
+/**
+ * @brief Replaces the contents of a file atomically by writing to a temporary file which is then renamed.
+ * Missing parent directories are created.
+ *
+ * @return True if the file was written.
+ */
+bool writeFileAtomically(const std::filesystem::path &path, std::span<const std::byte> bytes);
+
+} // namespace gtest
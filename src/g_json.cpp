@@ -0,0 +1,319 @@
+#include <cctype>
+#include <charconv>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "g_json.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+void writeJsonString(ostream &os, string_view text) {
+    os << '"';
+
+    for (const char c : text) {
+        switch (c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        case '\r':
+            os << "\\r";
+            break;
+        case '\t':
+            os << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                ios_base::fmtflags savedFlags(os.flags());
+                os << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c);
+                os.flags(savedFlags);
+            } else {
+                os << c;
+            }
+        }
+    }
+
+    os << '"';
+}
+
+class JsonValue::Parser {
+  public:
+    explicit Parser(string_view text) : text_{text} {}
+
+    optional<JsonValue> parseDocument() {
+        auto value = parseValue();
+        skipWhitespace();
+        if (!value || position_ != text_.size()) {
+            return nullopt;
+        }
+        return value;
+    }
+
+  private:
+    static constexpr int MaxDepth = 64;
+
+    optional<JsonValue> parseValue() {
+        skipWhitespace();
+        if (position_ >= text_.size() || depth_ > MaxDepth) {
+            return nullopt;
+        }
+
+        JsonValue result;
+        const char c = text_[position_];
+
+        if (c == '{') {
+            auto object = parseObject();
+            if (!object) {
+                return nullopt;
+            }
+            result.value_ = std::move(*object);
+        } else if (c == '[') {
+            auto array = parseArray();
+            if (!array) {
+                return nullopt;
+            }
+            result.value_ = std::move(*array);
+        } else if (c == '"') {
+            auto text = parseString();
+            if (!text) {
+                return nullopt;
+            }
+            result.value_ = std::move(*text);
+        } else if (consume("true")) {
+            result.value_ = true;
+        } else if (consume("false")) {
+            result.value_ = false;
+        } else if (consume("null")) {
+            result.value_ = nullptr;
+        } else {
+            auto number = parseNumber();
+            if (!number) {
+                return nullopt;
+            }
+            result.value_ = *number;
+        }
+
+        return result;
+    }
+
+    optional<Object> parseObject() {
+        Object object;
+        ++position_;
+        ++depth_;
+        skipWhitespace();
+
+        if (consume("}")) {
+            --depth_;
+            return object;
+        }
+
+        do {
+            skipWhitespace();
+            auto key = parseString();
+            skipWhitespace();
+            if (!key || !consume(":")) {
+                return nullopt;
+            }
+            auto value = parseValue();
+            if (!value) {
+                return nullopt;
+            }
+            object.emplace_back(std::move(*key), std::move(*value));
+            skipWhitespace();
+        } while (consume(","));
+
+        --depth_;
+        return consume("}") ? optional<Object>{std::move(object)} : nullopt;
+    }
+
+    optional<Array> parseArray() {
+        Array array;
+        ++position_;
+        ++depth_;
+        skipWhitespace();
+
+        if (consume("]")) {
+            --depth_;
+            return array;
+        }
+
+        do {
+            auto value = parseValue();
+            if (!value) {
+                return nullopt;
+            }
+            array.push_back(std::move(*value));
+            skipWhitespace();
+        } while (consume(","));
+
+        --depth_;
+        return consume("]") ? optional<Array>{std::move(array)} : nullopt;
+    }
+
+    optional<string> parseString() {
+        if (!consume("\"")) {
+            return nullopt;
+        }
+
+        string result;
+        while (position_ < text_.size()) {
+            const char c = text_[position_++];
+
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (position_ >= text_.size()) {
+                return nullopt;
+            }
+
+            switch (const char escaped = text_[position_++]) {
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'u': {
+                unsigned codePoint{0};
+                const auto hexDigits = text_.substr(position_, 4);
+                const auto [end, error] =
+                    from_chars(hexDigits.data(), hexDigits.data() + hexDigits.size(), codePoint, 16);
+                if (error != errc{} || end != hexDigits.data() + 4) {
+                    return nullopt;
+                }
+                position_ += 4;
+                appendUtf8(result, codePoint);
+                break;
+            }
+            default:
+                result += escaped;
+            }
+        }
+
+        return nullopt;
+    }
+
+    optional<double> parseNumber() {
+        const auto begin = position_;
+        constexpr string_view numberCharacters{"0123456789+-.eE"};
+        while (position_ < text_.size() && numberCharacters.find(text_[position_]) != string_view::npos) {
+            ++position_;
+        }
+
+        // from_chars does not accept a leading '+', which is not valid JSON anyway.
+        double number{0.0};
+        const auto numberText = text_.substr(begin, position_ - begin);
+        const auto *numberEnd = numberText.data() + numberText.size();
+        const auto [end, error] = from_chars(numberText.data(), numberEnd, number);
+        if (numberText.empty() || error != errc{} || end != numberEnd) {
+            return nullopt;
+        }
+
+        return number;
+    }
+
+    static void appendUtf8(string &text, unsigned codePoint) {
+        if (codePoint < 0x80) {
+            text += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            text += static_cast<char>(0xC0 | (codePoint >> 6));
+            text += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            text += static_cast<char>(0xE0 | (codePoint >> 12));
+            text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    void skipWhitespace() {
+        while (position_ < text_.size() && isspace(static_cast<unsigned char>(text_[position_]))) {
+            ++position_;
+        }
+    }
+
+    bool consume(string_view token) {
+        if (text_.substr(position_).starts_with(token)) {
+            position_ += token.size();
+            return true;
+        }
+        return false;
+    }
+
+    string_view text_;
+    size_t position_ = 0;
+    int depth_ = 0;
+};
+
+optional<JsonValue> JsonValue::parse(string_view text) { return Parser{text}.parseDocument(); }
+
+const JsonValue *JsonValue::find(string_view key) const {
+    if (const auto *object = get_if<Object>(&value_)) {
+        for (const auto &[memberKey, memberValue] : *object) {
+            if (memberKey == key) {
+                return &memberValue;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool JsonValue::asBool(bool defaultValue) const {
+    const auto *value = get_if<bool>(&value_);
+    return value != nullptr ? *value : defaultValue;
+}
+
+double JsonValue::asNumber(double defaultValue) const {
+    const auto *value = get_if<double>(&value_);
+    return value != nullptr ? *value : defaultValue;
+}
+
+string_view JsonValue::asString(string_view defaultValue) const {
+    const auto *value = get_if<string>(&value_);
+    return value != nullptr ? string_view{*value} : defaultValue;
+}
+
+const JsonValue::Array &JsonValue::asArray() const {
+    static const Array emptyArray;
+    const auto *value = get_if<Array>(&value_);
+    return value != nullptr ? *value : emptyArray;
+}
+
+double JsonValue::numberAt(string_view key, double defaultValue) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asNumber(defaultValue) : defaultValue;
+}
+
+string_view JsonValue::stringAt(string_view key, string_view defaultValue) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asString(defaultValue) : defaultValue;
+}
+
+const JsonValue::Array &JsonValue::arrayAt(string_view key) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asArray() : JsonValue{}.asArray();
+}
+
+} // namespace gtest
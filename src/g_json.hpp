@@ -0,0 +1,77 @@
+/**
+ * @file g_json.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Helpers for writing and reading the JSON output of the test framework.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Writes a string as a quoted and escaped JSON string.
+ */
+void writeJsonString(std::ostream &os, std::string_view text);
+
+/**
+ * @brief A parsed JSON value. Used by the tools reading the JSON output of the test framework, which is
+ * written as one JSON document per line.
+ */
+class JsonValue {
+  public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+
+    /**
+     * @brief Parses a JSON document.
+     *
+     * @return The parsed value, or empty if the text is not valid JSON.
+     */
+    static std::optional<JsonValue> parse(std::string_view text);
+
+    bool isNull() const { return std::holds_alternative<std::nullptr_t>(value_); }
+    bool isObject() const { return std::holds_alternative<Object>(value_); }
+
+    /**
+     * @brief Gives the member with the given key, or nullptr if this is not an object with that member.
+     */
+    const JsonValue *find(std::string_view key) const;
+
+    /**
+     * @brief The value as the given type, or the default value if it is of another type.
+     */
+    bool asBool(bool defaultValue = false) const;
+    double asNumber(double defaultValue = 0.0) const;
+    std::string_view asString(std::string_view defaultValue = {}) const;
+    const Array &asArray() const;
+
+    /**
+     * @brief Convenience functions which look up a member and give its value, or the default value.
+     */
+    double numberAt(std::string_view key, double defaultValue = 0.0) const;
+    std::string_view stringAt(std::string_view key, std::string_view defaultValue = {}) const;
+    const Array &arrayAt(std::string_view key) const;
+
+  private:
+    class Parser;
+
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value_;
+};
+
+} // namespace gtest
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "g_latency_histogram.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < 2 * HalfSubBucketCount) {
+        return index;
+    }
+
+    // Inverse of bucketIndex(): index = shift * 64 + subBucket where subBucket is in [64, 128).
+    const auto shift = index / HalfSubBucketCount - 1;
+    const auto subBucket = index - shift * HalfSubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < NumberOfBuckets; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = min(min_, other.min_);
+    max_ = max(max_, other.max_);
+}
+
+uint64_t LatencyHistogram::percentile(double percentage) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    const auto fraction = clamp(percentage, 0.0, 100.0) / 100.0;
+    const auto rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(fraction * static_cast<double>(count_))));
+
+    uint64_t cumulativeCount{0};
+    for (size_t i = 0; i < NumberOfBuckets; ++i) {
+        cumulativeCount += counts_[i];
+        if (cumulativeCount >= rank) {
+            return clamp(bucketUpperBound(i), min_, max_);
+        }
+    }
+
+    return max_;
+}
+
+} // namespace gtest
@@ -0,0 +1,84 @@
+/**
+ * @file g_latency_histogram.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief High dynamic range histogram of latencies recorded by benchmarks.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Histogram of latencies in nanoseconds with log-linear buckets, in the style of HdrHistogram.
+ *
+ * Values below 128 ns are counted exactly. Above that each power of two is divided into 64 linear buckets,
+ * so a value is represented with a relative error below 1.6% over the full 64 bit range. Recording a value
+ * is a few integer operations without allocation, and histograms recorded by different threads or
+ * repetitions are merged by adding their buckets.
+ */
+class LatencyHistogram {
+  public:
+    /**
+     * @brief Records one latency.
+     */
+    void record(std::uint64_t nanoseconds) {
+        ++counts_[bucketIndex(nanoseconds)];
+        ++count_;
+        sum_ += static_cast<double>(nanoseconds);
+        min_ = nanoseconds < min_ ? nanoseconds : min_;
+        max_ = nanoseconds > max_ ? nanoseconds : max_;
+    }
+
+    /**
+     * @brief Adds the latencies recorded by another histogram.
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Gives the latency below or equal to which the given percentage of the recorded latencies are,
+     * e.g. percentile(99.9). The value is the upper bound of its bucket, limited to the largest recorded
+     * latency.
+     */
+    std::uint64_t percentile(double percentage) const;
+
+    std::uint64_t getCount() const { return count_; }
+    std::uint64_t getMin() const { return count_ > 0 ? min_ : 0; }
+    std::uint64_t getMax() const { return max_; }
+    double getMean() const { return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0; }
+
+  private:
+    static constexpr int SubBucketBits = 7;
+    static constexpr std::uint64_t HalfSubBucketCount = 1ULL << (SubBucketBits - 1);
+    static constexpr std::size_t NumberOfBuckets = (64 - SubBucketBits + 1) * HalfSubBucketCount +
+                                                   HalfSubBucketCount;
+
+    static constexpr std::size_t bucketIndex(std::uint64_t value) {
+        // The shift keeps the SubBucketBits most significant bits of the value. The index of a shifted
+        // value is shift * 64 + (value >> shift), where value >> shift is in [64, 128).
+        const int shift = std::max(0, static_cast<int>(std::bit_width(value)) - SubBucketBits);
+        return (static_cast<std::size_t>(shift) << (SubBucketBits - 1)) +
+               static_cast<std::size_t>(value >> shift);
+    }
+
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+    std::array<std::uint64_t, NumberOfBuckets> counts_{};
+    std::uint64_t count_ = 0;
+    double sum_ = 0.0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+};
+
+} // namespace gtest
@@ -0,0 +1,181 @@
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "g_perf_counters.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+optional<uint64_t> addOptional(const optional<uint64_t> &a, const optional<uint64_t> &b) {
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    return *a + *b;
+}
+
+void writeJsonOptional(ostream &os, const optional<uint64_t> &value) {
+    if (value) {
+        os << *value;
+    } else {
+        os << "null";
+    }
+}
+
+void printOptional(ostream &os, const char *label, const optional<uint64_t> &value) {
+    os << label << '=';
+    if (value) {
+        os << *value;
+    } else {
+        os << "n/a";
+    }
+}
+
+#if defined(__linux__)
+constexpr array<uint64_t, 4> counterConfigs{PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+                                            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+int openCounter(uint64_t config, int groupFd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+} // namespace
+
+PerfCounterValues &PerfCounterValues::operator+=(const PerfCounterValues &other) {
+    instructions = addOptional(instructions, other.instructions);
+    cycles = addOptional(cycles, other.cycles);
+    cacheMisses = addOptional(cacheMisses, other.cacheMisses);
+    branchMisses = addOptional(branchMisses, other.branchMisses);
+    return *this;
+}
+
+ostream &operator<<(ostream &os, const PerfCounterValues &values) {
+    printOptional(os, "instructions", values.instructions);
+    printOptional(os << ' ', "cycles", values.cycles);
+    printOptional(os << ' ', "cache-misses", values.cacheMisses);
+    printOptional(os << ' ', "branch-misses", values.branchMisses);
+    return os;
+}
+
+void writePerfCountersJson(ostream &os, const PerfCounterValues &values) {
+    os << "{\"instructions\":";
+    writeJsonOptional(os, values.instructions);
+    os << ",\"cycles\":";
+    writeJsonOptional(os, values.cycles);
+    os << ",\"cacheMisses\":";
+    writeJsonOptional(os, values.cacheMisses);
+    os << ",\"branchMisses\":";
+    writeJsonOptional(os, values.branchMisses);
+    os << '}';
+}
+
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+    for (size_t i = 0; i < NumberOfCounters; ++i) {
+        fds_[i] = openCounter(counterConfigs[i], groupFd_);
+        if (groupFd_ == -1) {
+            groupFd_ = fds_[i];
+        }
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (auto fd : fds_) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    if (isAvailable()) {
+        ioctl(groupFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(groupFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounterValues PerfCounters::stop() {
+    pause();
+    return read();
+}
+
+void PerfCounters::pause() {
+#if defined(__linux__)
+    if (isAvailable()) {
+        ioctl(groupFd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounters::resume() {
+#if defined(__linux__)
+    if (isAvailable()) {
+        ioctl(groupFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounterValues PerfCounters::read() const {
+    PerfCounterValues values;
+
+#if defined(__linux__)
+    if (!isAvailable()) {
+        return values;
+    }
+
+    // Layout given by PERF_FORMAT_GROUP: nr, time_enabled, time_running, value[nr]
+    array<uint64_t, 3 + NumberOfCounters> buffer{};
+    if (::read(groupFd_, buffer.data(), sizeof(buffer)) <= 0) {
+        return values;
+    }
+
+    const auto timeEnabled = buffer[1];
+    const auto timeRunning = buffer[2];
+    const double scale =
+        (timeRunning > 0 && timeRunning < timeEnabled) ? static_cast<double>(timeEnabled) / timeRunning : 1.0;
+
+    array<optional<uint64_t> *, NumberOfCounters> targets{&values.instructions, &values.cycles,
+                                                          &values.cacheMisses, &values.branchMisses};
+
+    // The group values are reported in the order the counters were added to the group.
+    size_t valueIndex = 3;
+    for (size_t i = 0; i < NumberOfCounters; ++i) {
+        if (fds_[i] != -1 && valueIndex < 3 + buffer[0]) {
+            *targets[i] = static_cast<uint64_t>(static_cast<double>(buffer[valueIndex++]) * scale);
+        }
+    }
+#endif
+
+    return values;
+}
+
+} // namespace gtest
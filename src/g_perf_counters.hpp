@@ -0,0 +1,94 @@
+/**
+ * @file g_perf_counters.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Hardware performance counters based on Linux perf_event_open.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Holds the values of the hardware performance counters for a measured region. A counter which
+ * could not be opened on the current system is left empty.
+ */
+struct PerfCounterValues {
+    std::optional<std::uint64_t> instructions;
+    std::optional<std::uint64_t> cycles;
+    std::optional<std::uint64_t> cacheMisses;
+    std::optional<std::uint64_t> branchMisses;
+
+    PerfCounterValues &operator+=(const PerfCounterValues &other);
+};
+
+std::ostream &operator<<(std::ostream &os, const PerfCounterValues &values);
+
+/**
+ * @brief Writes the values as a JSON object, e.g. {"instructions":1200,"cycles":800,"cacheMisses":3,
+ * "branchMisses":null}, where a counter which is not available is null.
+ */
+void writePerfCountersJson(std::ostream &os, const PerfCounterValues &values);
+
+/**
+ * @brief Measures instructions, cycles, cache misses and branch misses of the calling thread.
+ *
+ * The counters are opened once at construction and reused for every measurement. If the counters are
+ * not available (non-Linux system, missing permissions, virtual machine without PMU etc.) isAvailable()
+ * returns false and start()/stop() does nothing.
+ */
+class PerfCounters {
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Returns true if at least one hardware counter could be opened.
+     */
+    bool isAvailable() const { return groupFd_ != -1; }
+
+    /**
+     * @brief Resets and starts the counters.
+     */
+    void start();
+
+    /**
+     * @brief Stops the counters and returns the values counted since start().
+     */
+    PerfCounterValues stop();
+
+    /**
+     * @brief Stops the counters without resetting them, e.g. while the timer of a benchmark is paused.
+     */
+    void pause();
+
+    /**
+     * @brief Continues counting after pause().
+     */
+    void resume();
+
+    /**
+     * @brief Returns the values counted since start(), excluding the paused intervals.
+     */
+    PerfCounterValues read() const;
+
+  private:
+    static constexpr std::size_t NumberOfCounters = 4;
+
+    int groupFd_ = -1;
+    std::array<int, NumberOfCounters> fds_{-1, -1, -1, -1};
+};
+
+} // namespace gtest
@@ -0,0 +1,66 @@
+/**
+ * @file g_print_table.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Colored table printing shared by the test framework and its tools.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+namespace PrintColor {
+inline constexpr std::string Black{"\033[30m"};
+inline constexpr std::string Red{"\033[31m"};
+inline constexpr std::string Green{"\033[32m"};
+inline constexpr std::string Yellow{"\033[33m"};
+inline constexpr std::string Blue{"\033[34m"};
+inline constexpr std::string Magenta{"\033[35m"};
+inline constexpr std::string Cyan{"\033[36m"};
+inline constexpr std::string White{"\033[37m"};
+
+inline constexpr std::string Reset{"\033[0m"};
+} // namespace PrintColor
+
+template <typename Type> void printRowColumn(int width, const std::string &color, const Type &element) {
+    std::cout << color;
+    std::cout << std::setw(width) << element;
+    std::cout << PrintColor::Reset;
+}
+
+/**
+ * @brief Prints a row of right aligned columns to cout.
+ *
+ * @param columnWidths The width of each column.
+ * @param colors The color of each column, see PrintColor.
+ * @param args The column values.
+ */
+template <typename... Args>
+void printTableRow(const std::vector<int> &columnWidths, const std::vector<std::string> &colors,
+                   Args... args) {
+    std::ios_base::fmtflags savedCoutFlags(std::cout.flags());
+
+    if (sizeof...(args) != columnWidths.size() || columnWidths.size() != colors.size()) {
+        throw std::invalid_argument("Number of widths and colors must match the number of arguments!");
+    }
+
+    int columnIndex{0};
+    int colorIndex{0};
+    std::cout << std::right;
+    (printRowColumn(columnWidths[columnIndex++], colors[colorIndex++], args), ...);
+    std::cout << std::endl;
+
+    std::cout.flags(savedCoutFlags); // restore cout formatting
+}
+
+} // namespace gtest
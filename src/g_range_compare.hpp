@@ -0,0 +1,160 @@
+/**
+ * @file g_range_compare.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Bulk comparison kernels used by the range checks of the test framework.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#pragma once
+
+namespace gtest::compare {
+
+/**
+ * @brief The maximum number of differing elements that are reported when a range check fails.
+ */
+constexpr std::size_t MaxReportedMismatches = 3;
+
+/**
+ * @brief Contiguous ranges with the same element type which can be compared by the range checks.
+ */
+template <typename ResultRange, typename ExpectedRange>
+concept ComparableRanges =
+    std::ranges::contiguous_range<ResultRange> && std::ranges::contiguous_range<ExpectedRange> &&
+    std::same_as<std::ranges::range_value_t<ResultRange>, std::ranges::range_value_t<ExpectedRange>>;
+
+/**
+ * @brief Tells if the predicate holds for all indices in [0, size).
+ *
+ * The indices are processed in fixed size blocks without early exit inside a block, which lets the
+ * compiler vectorize the loop. The search stops at the first block containing a mismatch.
+ *
+ * @param size The number of elements.
+ * @param matches Predicate telling if the elements at an index match.
+ */
+template <typename Predicate> constexpr bool allOf(std::size_t size, Predicate matches) {
+    constexpr std::size_t BlockSize = 256;
+
+    for (std::size_t begin = 0; begin < size; begin += BlockSize) {
+        const auto end = std::min(size, begin + BlockSize);
+        unsigned mismatches = 0;
+
+        for (auto i = begin; i < end; ++i) {
+            mismatches |= matches(i) ? 0U : 1U;
+        }
+
+        if (mismatches != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Gives the indices for which the predicate does not hold.
+ *
+ * This is the slow path which is only used to report a failed check.
+ *
+ * @param size The number of elements.
+ * @param matches Predicate telling if the elements at an index match.
+ * @param maxIndices The maximum number of indices to return.
+ * @param numberOfMismatches Set to the total number of mismatching indices.
+ */
+template <typename Predicate>
+std::vector<std::size_t> findMismatches(std::size_t size, Predicate matches, std::size_t maxIndices,
+                                        std::size_t &numberOfMismatches) {
+    std::vector<std::size_t> indices;
+    numberOfMismatches = 0;
+
+    for (std::size_t i = 0; i < size; ++i) {
+        if (!matches(i)) {
+            if (indices.size() < maxIndices) {
+                indices.push_back(i);
+            }
+            ++numberOfMismatches;
+        }
+    }
+
+    return indices;
+}
+
+/**
+ * @brief Tells if two ranges of the same size are equal. Types where equality means identical bytes
+ * are compared with memcmp, other types element by element with operator==.
+ */
+template <typename Type>
+constexpr bool allEqual(std::span<const Type> result, std::span<const Type> expected) {
+    if constexpr (std::has_unique_object_representations_v<Type>) {
+        return result.empty() || std::memcmp(result.data(), expected.data(), result.size_bytes()) == 0;
+    } else {
+        return allOf(result.size(), [&](std::size_t i) { return result[i] == expected[i]; });
+    }
+}
+
+/**
+ * @brief Tells if the result is within +/- tolerance/2 from the expected value.
+ */
+template <typename Type>
+constexpr bool isNear(const Type &result, const Type &expected, const Type &tolerance) {
+    return (result >= expected - tolerance / 2) && (result <= expected + tolerance / 2);
+}
+
+/**
+ * @brief Gives the distance in units in the last place (ULP) between two finite floating point values,
+ * i.e. the number of representable values between them. +0.0 and -0.0 have distance 0.
+ */
+template <std::floating_point Type> constexpr std::uint64_t ulpDistance(Type a, Type b) {
+    static_assert(sizeof(Type) == 4 || sizeof(Type) == 8, "Only 32 and 64 bit floating point is supported.");
+    using UInt = std::conditional_t<sizeof(Type) == 4, std::uint32_t, std::uint64_t>;
+    constexpr UInt signBit = UInt{1} << (sizeof(UInt) * 8 - 1);
+
+    // Maps the sign-magnitude representation to unsigned integers with the same ordering as the floating
+    // point values, with both zeros at signBit. The distance is then taken without a signed intermediate,
+    // which would wrap for values of opposite sign far apart. Written without branches so that it vectorizes.
+    const auto toOrdered = [](Type value) {
+        const auto bits = std::bit_cast<UInt>(value);
+        const auto magnitude = bits & ~signBit;
+        return (bits & signBit) != 0 ? signBit - magnitude : signBit + magnitude;
+    };
+
+    const auto orderedA = toOrdered(a);
+    const auto orderedB = toOrdered(b);
+    return static_cast<std::uint64_t>(orderedA > orderedB ? orderedA - orderedB : orderedB - orderedA);
+}
+
+/**
+ * @brief Tells if two floating point values are at most maxUlps units in the last place apart. NaN is
+ * never within any distance.
+ */
+template <std::floating_point Type>
+constexpr bool isWithinUlps(const Type &result, const Type &expected, std::uint64_t maxUlps) {
+    return (result == result) & (expected == expected) & (ulpDistance(result, expected) <= maxUlps);
+}
+
+/**
+ * @brief Tells if the result is within the relative tolerance from the expected value, i.e.
+ * |result - expected| <= relativeTolerance * max(|result|, |expected|).
+ */
+template <std::floating_point Type>
+constexpr bool isRelativelyNear(const Type &result, const Type &expected, const Type &relativeTolerance) {
+    const auto largest = std::max(std::abs(result), std::abs(expected));
+    return (result == expected) | (std::abs(result - expected) <= relativeTolerance * largest);
+}
+
+} // namespace gtest::compare
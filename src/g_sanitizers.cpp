@@ -0,0 +1,150 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#if defined(__GNUC__) && !defined(_WIN32)
+#include <unistd.h>
+#define GTEST_HAS_WEAK_SYMBOLS 1
+#endif
+
+#include "g_check_trace.hpp"
+#include "g_sanitizers.hpp"
+
+using namespace std;
+
+#if defined(GTEST_HAS_WEAK_SYMBOLS)
+
+// Functions of the sanitizer runtimes. They are only referenced weakly, so their addresses are null when the
+// runtime is not linked into the process.
+extern "C" {
+__attribute__((weak)) void __asan_init();
+__attribute__((weak)) void __asan_set_error_report_callback(void (*callback)(const char *));
+__attribute__((weak)) void __tsan_init();
+__attribute__((weak)) void __ubsan_handle_builtin_unreachable();
+}
+
+#endif
+
+namespace gtest {
+
+namespace {
+
+array<atomic<int64_t>, tuple_size_v<SanitizerFindings>> findings{};
+
+[[maybe_unused]] void countFinding(Sanitizer sanitizer) {
+    findings[static_cast<size_t>(sanitizer)].fetch_add(1, memory_order_relaxed);
+}
+
+#if defined(GTEST_HAS_WEAK_SYMBOLS)
+
+// By default AddressSanitizer ends the process after its first report, so the test case and its last checks
+// are written with the report.
+void onAddressSanitizerReport(const char *) {
+    countFinding(Sanitizer::Address);
+    CheckTrace::writeTrace(STDERR_FILENO);
+}
+
+#endif
+
+} // namespace
+
+#if defined(GTEST_HAS_WEAK_SYMBOLS)
+
+// Report hooks which the runtimes define as weak, empty functions to be overridden by the program. They are
+// only defined by the sanitizer variants of the library, see meson.build, so that the plain library does not
+// collide with a program or runtime which defines them.
+extern "C" {
+#if defined(GTEST_SANITIZE_UNDEFINED)
+void __ubsan_on_report() { countFinding(Sanitizer::UndefinedBehavior); }
+#endif
+#if defined(GTEST_SANITIZE_THREAD)
+void __tsan_on_report(const void *) { countFinding(Sanitizer::Thread); }
+#endif
+}
+
+#endif
+
+ostream &operator<<(ostream &os, Sanitizer sanitizer) {
+    switch (sanitizer) {
+    case Sanitizer::Address:
+        return os << "address";
+    case Sanitizer::UndefinedBehavior:
+        return os << "undefined";
+    default:
+        return os << "thread";
+    }
+}
+
+bool Sanitizers::isActive([[maybe_unused]] Sanitizer sanitizer) {
+#if defined(GTEST_HAS_WEAK_SYMBOLS)
+    switch (sanitizer) {
+    case Sanitizer::Address:
+        return __asan_init != nullptr;
+    case Sanitizer::UndefinedBehavior:
+#if defined(GTEST_SANITIZE_UNDEFINED)
+        return true;
+#elif defined(__clang__)
+        // Clang bundles the UBSan handlers into its ASan and TSan runtimes, so they only tell that UBSan is
+        // active when no other runtime is linked.
+        return __ubsan_handle_builtin_unreachable != nullptr && __asan_init == nullptr &&
+               __tsan_init == nullptr;
+#else
+        return __ubsan_handle_builtin_unreachable != nullptr;
+#endif
+    default:
+        return __tsan_init != nullptr;
+    }
+#else
+    return false;
+#endif
+}
+
+string Sanitizers::getActiveNames() {
+    string names;
+    for (auto sanitizer : {Sanitizer::Address, Sanitizer::UndefinedBehavior, Sanitizer::Thread}) {
+        if (isActive(sanitizer)) {
+            stringstream name;
+            name << sanitizer;
+            names += (names.empty() ? "" : ",") + name.str();
+        }
+    }
+    return names;
+}
+
+double Sanitizers::getTimeoutFactor() {
+    // Typical slowdowns of instrumented code, combined sanitizers compound.
+    double factor{1.0};
+    if (isActive(Sanitizer::Address)) {
+        factor *= 3.0;
+    }
+    if (isActive(Sanitizer::UndefinedBehavior)) {
+        factor *= 2.0;
+    }
+    if (isActive(Sanitizer::Thread)) {
+        factor *= 10.0;
+    }
+    return factor;
+}
+
+void Sanitizers::installHooks() {
+#if defined(GTEST_HAS_WEAK_SYMBOLS)
+    if (__asan_set_error_report_callback != nullptr) {
+        __asan_set_error_report_callback(onAddressSanitizerReport);
+    }
+#endif
+}
+
+SanitizerFindings Sanitizers::getFindings() {
+    SanitizerFindings counts{};
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = findings[i].load(memory_order_relaxed);
+    }
+    return counts;
+}
+
+} // namespace gtest
@@ -0,0 +1,74 @@
+/**
+ * @file g_sanitizers.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Detection of the sanitizers a test binary runs under and attribution of their findings.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#pragma once
+
+namespace gtest {
+
+enum class Sanitizer {
+    Address,
+    UndefinedBehavior,
+    Thread,
+};
+
+std::ostream &operator<<(std::ostream &os, Sanitizer sanitizer);
+
+/**
+ * @brief The number of findings reported by each sanitizer, indexed by Sanitizer.
+ */
+using SanitizerFindings = std::array<std::int64_t, 3>;
+
+/**
+ * @brief Detects the sanitizer runtimes linked into the process and counts the findings they report.
+ *
+ * The runtimes are detected through weak references to their functions, so the detection works whether or
+ * not the gtest library itself is instrumented. The findings are counted by the report hooks of the
+ * runtimes, which are called on the thread where the finding was made. The UBSan and TSan hooks are
+ * overridden by symbol, so only the sanitizer variants of the library define them. A test case whose body
+ * caused a finding fails, see TestBase::execute().
+ */
+class Sanitizers {
+  public:
+    /**
+     * @brief Tells if the runtime of a sanitizer is linked into the process.
+     */
+    static bool isActive(Sanitizer sanitizer);
+
+    /**
+     * @brief Gives the names of the active sanitizers separated by commas, e.g. "address,undefined", or an
+     * empty string if none is active.
+     */
+    static std::string getActiveNames();
+
+    /**
+     * @brief Gives the factor the timeouts are multiplied with to account for the slowdown caused by the
+     * instrumentation of the active sanitizers, 1.0 if none is active.
+     */
+    static double getTimeoutFactor();
+
+    /**
+     * @brief Registers the report callbacks which cannot be registered by symbol overriding. Calling it more
+     * than once has no effect.
+     */
+    static void installHooks();
+
+    /**
+     * @brief Gives the number of findings reported so far by each sanitizer.
+     */
+    static SanitizerFindings getFindings();
+};
+
+} // namespace gtest
@@ -1,54 +1,35 @@
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
 #include <exception>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
-#include <numeric>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <typeinfo>
 #include <vector>
 
+#include "g_json.hpp"
+#include "g_print_table.hpp"
 #include "g_test_framework.hpp"
+#include "g_test_server.hpp"
 
 using namespace std;
 
 namespace gtest {
 
-namespace PrintColor {
-constexpr string Black{"\033[30m"};
-constexpr string Red{"\033[31m"};
-constexpr string Green{"\033[32m"};
-constexpr string Yellow{"\033[33m"};
-constexpr string Blue{"\033[34m"};
-constexpr string Magenta{"\033[35m"};
-constexpr string Cyan{"\033[36m"};
-constexpr string White{"\033[37m"};
-
-constexpr string Reset{"\033[0m"};
-} // namespace PrintColor
-
-template <typename Type> void printRowColumn(int width, const string &color, const Type &element) {
-    cout << color;
-    cout << std::setw(width) << element;
-    cout << PrintColor::Reset;
-}
-
-template <typename... Args>
-void printTableRow(const std::vector<int> &columnWidths, const std::vector<string> &colors, Args... args) {
-    ios_base::fmtflags savedCoutFlags(cout.flags());
-
-    if (sizeof...(args) != columnWidths.size() || columnWidths.size() != colors.size()) {
-        throw std::invalid_argument("Number of widths and colors must match the number of arguments!");
-    }
-
-    int columnIndex{0};
-    int colorIndex{0};
-    cout << right;
-    (printRowColumn(columnWidths[columnIndex++], colors[colorIndex++], args), ...);
-    cout << endl;
-
-    cout.flags(savedCoutFlags); // restore cout formatting
-}
-
 const vector<int> testResultsTableColumnWidths{4, 30, 10, 10, 15};
 const auto defaultTableColumnColors = vector<string>(testResultsTableColumnWidths.size(), PrintColor::Reset);
 
@@ -58,109 +39,161 @@ void printTestResultTableHeader() {
 }
 
 void printTestResultTableRow(int testNo, const TestResult &result) {
-    string status;
+    const auto status = result.getStatus();
     vector<string> colors{defaultTableColumnColors};
     constexpr auto resultColumn{4};
 
-    if (!result.exceptions.empty()) {
-        status = "EXCEPTION";
+    if (status == "EXCEPTION") {
         colors[resultColumn] = PrintColor::Magenta;
-    } else if (!result.failedChecks.empty()) {
-        status = "FAILED";
+    } else if (status == "FAILED") {
         colors[resultColumn] = PrintColor::Red;
-    } else if (result.numberExecutedChecks > 0) {
-        status = "PASSED";
+    } else if (status == "PASSED") {
         colors[resultColumn] = PrintColor::Green;
-    } else {
-        status = "NOT PERFORMED";
     }
 
     printTableRow(testResultsTableColumnWidths, colors, testNo, result.testName, result.numberExecutedChecks,
-                  result.failedChecks.size(), status);
+                  result.numberFailedChecks, status);
 }
 
-int TestFramework::numberOfExecutedChecks() const {
-    auto accExecutedChecks = [](int sum, const TestBase *test) {
-        return sum + test->getTestResult().numberExecutedChecks;
-    };
+void writeTestResultJson(ostream &os, const TestBase &test) {
+    const TestResult &result = test.getTestResult();
+
+    os << "{\"name\":";
+    writeJsonString(os, result.testName);
+    os << ",\"file\":";
+    writeJsonString(os, test.getLocation().file_name());
+    os << ",\"line\":" << test.getLocation().line() << ",\"status\":";
+    writeJsonString(os, result.getStatus());
+    os << ",\"checks\":" << result.numberExecutedChecks << ",\"failedChecks\":" << result.numberFailedChecks
+       << ",\"durationNs\":" << result.duration.count() << ",\"counters\":[";
+
+    const char *separator = "";
+    for (const auto &counter : result.counters) {
+        os << separator << "{\"name\":";
+        writeJsonString(os, counter.name);
+        os << ",\"kind\":\"" << counter.kind << "\",\"value\":" << counter.value << '}';
+        separator = ",";
+    }
 
-    return accumulate(tests_.begin(), tests_.end(), 0, accExecutedChecks);
-}
+    os << "],\"perfCounters\":";
+    if (result.perfCounters) {
+        writePerfCountersJson(os, *result.perfCounters);
+    } else {
+        os << "null";
+    }
 
-int TestFramework::numberOfFailedChecks() const {
-    auto accExecutedChecks = [](int sum, const TestBase *test) {
-        return sum + test->getTestResult().failedChecks.size();
-    };
+    os << ",\"failures\":[";
 
-    return accumulate(tests_.begin(), tests_.end(), 0, accExecutedChecks);
-}
+    separator = "";
+    for (const auto &check : result.failedChecks) {
+        os << separator << "{\"check\":" << check.checkNumber << ",\"name\":";
+        writeJsonString(os, check.checkName);
+        os << ",\"message\":";
+        writeJsonString(os, check.failMessage);
+        os << ",\"fatal\":" << (check.fatal ? "true" : "false") << '}';
+        separator = ",";
+    }
 
-auto TestFramework::getPassedTests() const {
-    auto passedTestFilter = [](const TestBase *test) {
-        const TestResult &result = test->getTestResult();
-        return (result.failedChecks.empty()) && (result.numberExecutedChecks > 0);
-    };
+    os << "],\"exceptions\":[";
+    separator = "";
+    for (const auto &exception : result.exceptions) {
+        os << separator << "{\"type\":";
+        writeJsonString(os, exception.type);
+        os << ",\"message\":";
+        writeJsonString(os, exception.message);
+        os << '}';
+        separator = ",";
+    }
 
-    return tests_ | ranges::views::filter(passedTestFilter);
+    os << "]}\n" << flush;
 }
 
-auto TestFramework::getFailedTests() const {
-    auto failedTestFilter = [](const TestBase *test) {
-        return test->getTestResult().failedChecks.size() > 0;
-    };
+bool matchesPattern(string_view text, string_view pattern) {
+    size_t textIndex{0};
+    size_t patternIndex{0};
+    optional<size_t> starIndex;
+    size_t starTextIndex{0};
+
+    // Greedy wildcard matching which backtracks to the last '*' on mismatch.
+    while (textIndex < text.size()) {
+        const bool isPatternLeft = patternIndex < pattern.size();
+
+        if (isPatternLeft && (pattern[patternIndex] == '?' || pattern[patternIndex] == text[textIndex])) {
+            ++textIndex;
+            ++patternIndex;
+        } else if (isPatternLeft && pattern[patternIndex] == '*') {
+            starIndex = patternIndex++;
+            starTextIndex = textIndex;
+        } else if (starIndex) {
+            patternIndex = *starIndex + 1;
+            textIndex = ++starTextIndex;
+        } else {
+            return false;
+        }
+    }
+
+    while (patternIndex < pattern.size() && pattern[patternIndex] == '*') {
+        ++patternIndex;
+    }
 
-    return tests_ | ranges::views::filter(failedTestFilter);
+    return patternIndex == pattern.size();
 }
 
-auto TestFramework::getTestsWithExceptions() const {
-    auto exceptionFilter = [](const TestBase *test) { return test->getTestResult().exceptions.size() > 0; };
+string perfCounterText(const optional<uint64_t> &value) { return value ? to_string(*value) : "n/a"; }
 
-    return tests_ | ranges::views::filter(exceptionFilter);
-}
+void TestRunStatistics::addTestResult(const TestResult &result) {
+    ++numberOfExecutedTests;
+    numberOfExecutedChecks += result.numberExecutedChecks;
+    numberOfFailedChecks += result.numberFailedChecks;
 
-auto TestFramework::getNumberOfExecutedChecks() const {
-    auto accFunc = [](auto sum, const TestBase *test) {
-        return sum + test->getTestResult().numberExecutedChecks;
-    };
+    if (result.numberFailedChecks > 0) {
+        ++numberOfFailedTests;
+    } else if (result.numberExecutedChecks > 0) {
+        ++numberOfPassedTests;
+    }
 
-    return accumulate(tests_.begin(), tests_.end(), 0, accFunc);
+    if (result.numberOfExceptions > 0) {
+        ++numberOfTestsWithExceptions;
+    }
 }
 
 void TestFramework::printTestSummary() const {
-    const vector<int> testSummaryTableColumnWidths{20, 20, 20, 20};
-
-    auto passedTests = getPassedTests();
-    auto failedTests = getFailedTests();
-    auto testsWithExceptions = getTestsWithExceptions();
-    const auto noPassedTests = ranges::distance(passedTests);
-    const auto noFailedTests = ranges::distance(failedTests);
-    const auto noTestsWithExceptions = ranges::distance(testsWithExceptions);
-    const auto noExecutedChecks = getNumberOfExecutedChecks();
-
-    const string result{numberOfFailedChecks() == 0 ? "SUCCESS!" : "FAILED"};
-    const string resultColor{numberOfFailedChecks() == 0 ? PrintColor::Green : PrintColor::Red};
+    const string result{statistics_.isSuccess() ? "SUCCESS!" : "FAILED"};
+    const string resultColor{statistics_.isSuccess() ? PrintColor::Green : PrintColor::Red};
 
     cout << endl;
     cout << "TEST SUMMARY: " << resultColor << result << PrintColor::Reset << endl;
-    cout << "  " << noExecutedChecks << " checks executed for " << tests_.size() << " test cases." << endl;
-    if (noFailedTests > 0) {
-        cout << "  " << noPassedTests << " passed tests " << noFailedTests << " failed tests." << endl;
+    cout << "  " << statistics_.numberOfExecutedChecks << " checks executed for "
+         << statistics_.numberOfExecutedTests << " test cases." << endl;
+    if (statistics_.numberOfFailedTests > 0) {
+        cout << "  " << statistics_.numberOfPassedTests << " passed tests " << statistics_.numberOfFailedTests
+             << " failed tests." << endl;
+    }
+    if (statistics_.numberOfTestsWithExceptions > 0) {
+        cout << "  " << statistics_.numberOfTestsWithExceptions << " tests was terminated with an exception."
+             << endl;
     }
-    if (noTestsWithExceptions > 0) {
-        cout << "  " << noTestsWithExceptions << " tests was terminated with an exception." << endl;
+    if (statistics_.numberOfSkippedTests > 0) {
+        cout << "  Stopped at the first failure, " << statistics_.numberOfSkippedTests
+             << " test cases were not executed." << endl;
     }
     cout << endl;
 
-    for (auto *test : failedTests) {
+    for (auto *test : failedTests_) {
         const TestResult &result = test->getTestResult();
 
         for (auto check : result.failedChecks) {
-            cout << "# Failed: " << test->getTestName() << " check " << check.checkNumber << " ("
-                 << check.checkName << ") | " << check.failMessage << endl;
+            cout << (check.fatal ? "# Assertion failed: " : "# Failed: ") << test->getTestName() << " check "
+                 << check.checkNumber << " (" << check.checkName << ") | " << check.failMessage << endl;
+        }
+
+        const auto numberOfOmittedFailures = result.numberFailedChecks - ssize(result.failedChecks);
+        if (numberOfOmittedFailures > 0) {
+            cout << "# Failed: " << test->getTestName() << " +" << numberOfOmittedFailures << " more" << endl;
         }
     }
 
-    for (auto *test : testsWithExceptions) {
+    for (auto *test : testsWithExceptions_) {
         const TestResult &result = test->getTestResult();
 
         for (auto except : result.exceptions) {
@@ -171,24 +204,388 @@ void TestFramework::printTestSummary() const {
     cout << endl << endl;
 }
 
-void TestFramework::executeTests() {
+void TestFramework::printPerfCounters() const {
+    cout << endl;
+
+    if (getPerfCounters() == nullptr) {
+        cout << "PERFORMANCE COUNTERS: not available on this system." << endl;
+        return;
+    }
+
+    const vector<int> perfCountersTableColumnWidths{4, 30, 16, 16, 16, 16};
+    const auto colors = vector<string>(perfCountersTableColumnWidths.size(), PrintColor::Reset);
+
+    cout << "PERFORMANCE COUNTERS:" << endl;
+    printTableRow(perfCountersTableColumnWidths, colors, "#", "Test Name", "Instructions", "Cycles",
+                  "Cache Misses", "Branch Misses");
+
+    int testNo{0};
+    for (auto *test : tests_) {
+        ++testNo;
+        const TestResult &result = test->getTestResult();
+
+        if (result.perfCounters) {
+            const PerfCounterValues &values = *result.perfCounters;
+            printTableRow(perfCountersTableColumnWidths, colors, testNo, result.testName,
+                          perfCounterText(values.instructions), perfCounterText(values.cycles),
+                          perfCounterText(values.cacheMisses), perfCounterText(values.branchMisses));
+        }
+    }
+}
+
+void TestFramework::printUserCounters() const {
+    const vector<int> userCountersTableColumnWidths{4, 30, 20, 10, 16};
+    const auto colors = vector<string>(userCountersTableColumnWidths.size(), PrintColor::Reset);
+
+    cout << endl << "COUNTERS:" << endl;
+    printTableRow(userCountersTableColumnWidths, colors, "#", "Test Name", "Counter", "Kind", "Value");
+
+    int rowNo{0};
+    for (const auto *test : testsWithCounters_) {
+        for (const auto &counter : test->getTestResult().counters) {
+            stringstream kind;
+            kind << counter.kind;
+            printTableRow(userCountersTableColumnWidths, colors, ++rowNo, test->getTestName(), counter.name,
+                          kind.str(), counterValueText(counter));
+        }
+    }
+}
+
+void TestResult::addFailedCheck(int checkNumber, string_view name, string_view message) {
+    failedChecks.emplace_back(checkNumber, storeString(name), storeString(message));
+}
+
+void TestResult::addException(const std::exception &exception) {
+    exceptions.emplace_back(storeString(exception.what()), storeString(typeid(exception).name()));
+    ++numberOfExceptions;
+}
+
+string_view TestResult::getStatus() const {
+    if (numberOfExceptions > 0) {
+        return "EXCEPTION";
+    } else if (numberFailedChecks > 0) {
+        return "FAILED";
+    } else if (numberExecutedChecks > 0) {
+        return "PASSED";
+    }
+    return "NOT PERFORMED";
+}
+
+void TestResult::reset() {
+    numberExecutedChecks = 0;
+    numberFailedChecks = 0;
+    numberOfExceptions = 0;
+    perfCounters.reset();
+    counters.clear();
+    duration = chrono::nanoseconds{0};
+    releaseFailureRecords();
+}
+
+void TestResult::releaseFailureRecords() {
+    // The vectors must give up their storage before the arena is released.
+    pmr::vector<FailedCheck>{&arena_}.swap(failedChecks);
+    pmr::vector<ExceptionInfo>{&arena_}.swap(exceptions);
+    arena_.release();
+}
+
+string_view TestResult::storeString(string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+
+    auto *storage = static_cast<char *>(arena_.allocate(text.size(), alignof(char)));
+    copy(text.begin(), text.end(), storage);
+    return {storage, text.size()};
+}
+
+int TestFramework::executeTests() { return executeTests(string_view{}); }
+
+int TestFramework::executeTests(string_view filter) {
+    statistics_ = TestRunStatistics{};
+    failedTests_.clear();
+    testsWithExceptions_.clear();
+    testsWithCounters_.clear();
+    CheckTrace::installCrashHandler();
+    Sanitizers::installHooks();
+
+    ofstream resultsFile;
+    if (!resultsFile_.empty()) {
+        resultsFile.open(resultsFile_, ios::trunc);
+        if (!resultsFile) {
+            cerr << "Could not open results file " << resultsFile_.string() << endl;
+        }
+        resultsFile << setprecision(numeric_limits<double>::digits10);
+    }
+
+    if (const auto sanitizers = Sanitizers::getActiveNames(); !sanitizers.empty()) {
+        cout << "Running under sanitizers: " << sanitizers << endl << endl;
+    }
+
     printTestResultTableHeader();
 
     for (auto test : tests_) {
+        if (!matchesFilter(test->getTestName(), filter)) {
+            continue;
+        }
+        if (failFast_ && !statistics_.isSuccess()) {
+            ++statistics_.numberOfSkippedTests;
+            continue;
+        }
+
         test->execute();
-        ++numberOfExecutedTests_;
-        printTestResultTableRow(numberOfExecutedTests_, test->getTestResult());
+        if (resultsFile) {
+            writeTestResultJson(resultsFile, *test);
+        }
+
+        const TestResult &result = test->getTestResult();
+        statistics_.addTestResult(result);
+        if (result.numberFailedChecks > 0) {
+            failedTests_.push_back(test);
+        }
+        if (result.numberOfExceptions > 0) {
+            testsWithExceptions_.push_back(test);
+        }
+        if (!result.counters.empty()) {
+            testsWithCounters_.push_back(test);
+        }
+
+        printTestResultTableRow(statistics_.numberOfExecutedTests, result);
+    }
+
+    if (perfCounters_) {
+        printPerfCounters();
+    }
+
+    if (!testsWithCounters_.empty()) {
+        printUserCounters();
     }
 
     printTestSummary();
+
+    for (auto *test : tests_) {
+        test->releaseFailureRecords();
+    }
+
+    return statistics_.isSuccess() ? 0 : 1;
+}
+
+bool TestFramework::matchesFilter(string_view testName, string_view filter) {
+    if (filter.empty()) {
+        return true;
+    }
+
+    for (const auto pattern : views::split(filter, ',')) {
+        if (matchesPattern(testName, string_view{pattern.begin(), pattern.end()})) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int TestFramework::executeTests(int argc, char *argv[]) {
+    optional<ListFormat> listFormat;
+    optional<string_view> serverSocket;
+    string_view filter;
+
+    for (int i = 1; i < argc; ++i) {
+        const string_view argument{argv[i]};
+        constexpr string_view goldenDirOption{"--golden-dir="};
+        constexpr string_view filterOption{"--filter="};
+        constexpr string_view serverOption{"--server="};
+        constexpr string_view resultsOption{"--results-json="};
+        constexpr string_view timeoutOption{"--timeout="};
+
+        if (argument == "--list-tests") {
+            listFormat = ListFormat::Plain;
+        } else if (argument == "--list-tests=json") {
+            listFormat = ListFormat::Json;
+        } else if (argument == "--update-golden") {
+            setUpdateGoldenFiles(true);
+        } else if (argument.starts_with(goldenDirOption)) {
+            setGoldenDirectory(argument.substr(goldenDirOption.size()));
+        } else if (argument.starts_with(filterOption)) {
+            filter = argument.substr(filterOption.size());
+        } else if (argument.starts_with(serverOption)) {
+            serverSocket = argument.substr(serverOption.size());
+        } else if (argument.starts_with(resultsOption)) {
+            setResultsFile(argument.substr(resultsOption.size()));
+        } else if (argument == "--fail-fast") {
+            setFailFast(true);
+        } else if (argument.starts_with(timeoutOption)) {
+            const auto value = argument.substr(timeoutOption.size());
+            constexpr auto maxSeconds = chrono::duration<double>(chrono::nanoseconds::max()).count();
+            double seconds{0.0};
+            const auto [end, error] = from_chars(value.data(), value.data() + value.size(), seconds);
+            if (error != errc{} || end != value.data() + value.size() || !isfinite(seconds) ||
+                seconds < 0.0 || seconds >= maxSeconds) {
+                cerr << "Invalid timeout: " << argument << endl;
+                return 2;
+            }
+            setTestTimeout(chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double>(seconds)));
+        } else {
+            cerr << "Ignoring unknown option: " << argument << endl;
+        }
+    }
+
+    if (listFormat) {
+        listTests(cout, *listFormat);
+        return 0;
+    }
+
+    if (serverSocket) {
+        CheckTrace::installCrashHandler();
+        Sanitizers::installHooks();
+        return TestServer{*this, *serverSocket}.run() ? 0 : 2;
+    }
+
+    return executeTests(filter);
+}
+
+void TestFramework::listTests(ostream &os, ListFormat format) const {
+    if (format == ListFormat::Plain) {
+        for (const auto *test : tests_) {
+            const auto &location = test->getLocation();
+            os << test->getTestName() << ' ' << location.file_name() << ':' << location.line() << '\n';
+        }
+        os << flush;
+        return;
+    }
+
+    os << "{\"tests\":[";
+    const char *separator = "\n";
+    for (const auto *test : tests_) {
+        const auto &location = test->getLocation();
+        os << separator << "{\"name\":";
+        writeJsonString(os, test->getTestName());
+        os << ",\"file\":";
+        writeJsonString(os, location.file_name());
+        os << ",\"line\":" << location.line() << '}';
+        separator = ",\n";
+    }
+    os << "\n]}" << endl;
+}
+
+void TestFramework::enablePerfCounters(bool enable) {
+    if (enable && !perfCounters_) {
+        perfCounters_ = make_unique<PerfCounters>();
+    } else if (!enable) {
+        perfCounters_.reset();
+    }
+}
+
+void TestFramework::setTestTimeout(chrono::nanoseconds timeout) {
+    watchdog_.reset();
+    if (timeout > chrono::nanoseconds{0}) {
+        const auto scaledTimeout = chrono::duration<double, nano>(timeout) * Sanitizers::getTimeoutFactor();
+        watchdog_ = make_unique<TestWatchdog>(chrono::duration_cast<chrono::nanoseconds>(scaledTimeout));
+    }
+}
+
+PerfCounters *TestFramework::getPerfCounters() const {
+    return (perfCounters_ && perfCounters_->isAvailable()) ? perfCounters_.get() : nullptr;
 }
 
 void TestBase::execute() {
+    PerfCounters *perfCounters = framework_.getPerfCounters();
+    TestWatchdog *watchdog = framework_.getWatchdog();
+
+    testResult_.reset();
+    CheckTrace::setCurrentTest(getTestName());
+    const auto sanitizerFindings = Sanitizers::getFindings();
+
+    if (watchdog != nullptr) {
+        watchdog->start(getTestName());
+    }
+    if (perfCounters != nullptr) {
+        perfCounters->start();
+    }
+
+    const auto startTime = chrono::steady_clock::now();
+
     try {
         testBody();
+    } catch (const AssertionFailure &) {
+        // The failed check is already recorded, the rest of the test body is skipped.
     } catch (const std::exception &exception) {
-        testResult_.exceptions.emplace_back(ExceptionInfo{exception});
+        testResult_.addException(exception);
+    }
+
+    testResult_.duration = chrono::steady_clock::now() - startTime;
+    CheckTrace::setCurrentTest({});
+    testResult_.counters.resolve(testResult_.duration);
+
+    if (perfCounters != nullptr) {
+        testResult_.perfCounters = perfCounters->stop();
+    }
+    if (watchdog != nullptr) {
+        watchdog->stop();
+    }
+
+    recordSanitizerFindings(sanitizerFindings);
+}
+
+void TestBase::recordSanitizerFindings(const SanitizerFindings &findingsBefore) {
+    const auto findings = Sanitizers::getFindings();
+
+    for (size_t i = 0; i < findings.size(); ++i) {
+        const auto numberOfFindings = findings[i] - findingsBefore[i];
+        if (numberOfFindings == 0) {
+            continue;
+        }
+
+        // Counted without countFailedCheck(), as the finding is not made by the last check of the trace.
+        testResult_.numberFailedChecks++;
+        if (testResult_.failedChecks.size() < framework_.getMaxRecordedFailures()) {
+            stringstream failMessage;
+            failMessage << numberOfFindings << " finding(s) of the " << static_cast<Sanitizer>(i)
+                        << " sanitizer, see its report on stderr";
+            testResult_.addFailedCheck(testResult_.numberExecutedChecks, "sanitizer", failMessage.view());
+        }
+    }
+}
+
+bool TestBase::GCHECK_GOLDEN(const std::string &name, span<const byte> bytes, source_location location) {
+    beginCheck(location);
+
+    const auto path = framework_.getGoldenDirectory() / name;
+    optional<string> failure;
+
+    if (framework_.isUpdatingGoldenFiles()) {
+        if (!writeFileAtomically(path, bytes)) {
+            failure = "Could not update golden file " + path.string();
+        }
+    } else {
+        failure = compareWithGoldenFile(path, bytes);
+    }
+
+    if (failure && countFailedCheck()) {
+        testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, *failure);
+    }
+
+    return !failure;
+}
+
+bool TestBase::checkRangeSizes(const std::string &name, size_t resultSize, size_t expectedSize) {
+    if (resultSize == expectedSize) {
+        return true;
+    }
+
+    if (countFailedCheck()) {
+        stringstream failMessage;
+        failMessage << "Size: " << resultSize << " | Expected size: " << expectedSize;
+        testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+    }
+
+    return false;
+}
+
+void TestBase::abortTestBody() {
+    if (!testResult_.failedChecks.empty() &&
+        testResult_.failedChecks.back().checkNumber == testResult_.numberExecutedChecks) {
+        testResult_.failedChecks.back().fatal = true;
     }
+    throw AssertionFailure{};
 }
 
 } // namespace gtest
\ No newline at end of file
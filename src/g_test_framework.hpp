@@ -9,21 +9,47 @@
  *
  */
 
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <source_location>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
+#include "g_check_trace.hpp"
+#include "g_golden_file.hpp"
+#include "g_perf_counters.hpp"
+#include "g_range_compare.hpp"
+#include "g_sanitizers.hpp"
+#include "g_test_watchdog.hpp"
+#include "g_user_counters.hpp"
+
 #pragma once
 
 namespace gtest {
 
+/**
+ * @brief Holds information about an exception thrown by a test case. The strings are owned by the
+ * TestResult that holds the record.
+ */
 struct ExceptionInfo {
-    explicit ExceptionInfo(const std::exception &e) : message{e.what()}, type{typeid(e).name()} {}
+    ExceptionInfo(std::string_view msg, std::string_view typeName) : message{msg}, type{typeName} {}
 
-    std::string message;
-    std::string type;
+    std::string_view message;
+    std::string_view type;
 };
 
 constexpr std::ostream &operator<<(std::ostream &os, const ExceptionInfo &gei) {
@@ -37,30 +63,151 @@ constexpr std::ostream &operator<<(std::ostream &os, const std::exception &excep
 };
 
 /**
- * @brief Holds information about failed checks.
+ * @brief Holds information about failed checks. The strings are owned by the TestResult that holds the
+ * record.
  */
 struct FailedCheck {
 
-    FailedCheck(int checkNr, const std::string &name, const std::string &message)
+    FailedCheck(int checkNr, std::string_view name, std::string_view message)
         : checkNumber{checkNr}, checkName{name}, failMessage{message} {}
 
     int checkNumber = 0;
-    std::string checkName;
-    std::string failMessage;
+    std::string_view checkName;
+    std::string_view failMessage;
+    bool fatal = false;
 };
 
+/**
+ * @brief Thrown by the GASSERT checks to abort the test body. It is intentionally not derived from
+ * std::exception so that it is not caught by exception handlers in the test body.
+ */
+struct AssertionFailure {};
+
 /**
  * @brief Holds the results of a test case.
+ *
+ * The failure records and their strings are allocated from a monotonic arena owned by the result, so
+ * that a failing test does not make one heap allocation per string. The arena is released in bulk by
+ * releaseFailureRecords() when the results have been reported.
  */
 struct TestResult {
-    std::string testName;
+  private:
+    std::pmr::monotonic_buffer_resource arena_; // Must be constructed before the containers using it.
+
+  public:
+    TestResult() = default;
+    TestResult(const TestResult &) = delete;
+    TestResult &operator=(const TestResult &) = delete;
+
+    std::string_view testName;
     int numberExecutedChecks = 0;
-    std::vector<FailedCheck> failedChecks;
-    std::vector<ExceptionInfo> exceptions;
+    int numberFailedChecks = 0;
+    int numberOfExceptions = 0; ///< Kept when the exception records are released.
+    std::pmr::vector<FailedCheck> failedChecks{&arena_}; ///< First failures, see setMaxRecordedFailures().
+    std::pmr::vector<ExceptionInfo> exceptions{&arena_};
+    std::optional<PerfCounterValues> perfCounters;
+    UserCounters counters; ///< Rates are computed over the duration of the test case.
+    std::chrono::nanoseconds duration{0};
+
+    /**
+     * @brief Gives the status of the test case as shown in the result table: "PASSED", "FAILED",
+     * "EXCEPTION" or "NOT PERFORMED".
+     */
+    std::string_view getStatus() const;
+
+    /**
+     * @brief Records details about a failed check. The strings are copied into the arena.
+     */
+    void addFailedCheck(int checkNumber, std::string_view name, std::string_view message);
+
+    /**
+     * @brief Records an exception thrown by the test case. The strings are copied into the arena.
+     */
+    void addException(const std::exception &exception);
+
+    /**
+     * @brief Releases all failure records and their strings in one go. The check and exception counters
+     * are kept, so the status of the test case does not change.
+     */
+    void releaseFailureRecords();
+
+    /**
+     * @brief Clears the result before the test case is executed again. The test name is kept.
+     */
+    void reset();
+
+  private:
+    std::string_view storeString(std::string_view text);
+};
+
+/**
+ * @brief Aggregated results of a test run. It is updated as each test case completes so that the
+ * summary can be produced without scanning all test cases.
+ */
+struct TestRunStatistics {
+    int numberOfExecutedTests = 0;
+    int numberOfPassedTests = 0;
+    int numberOfFailedTests = 0;
+    int numberOfTestsWithExceptions = 0;
+    long long numberOfExecutedChecks = 0;
+    long long numberOfFailedChecks = 0;
+    int numberOfSkippedTests = 0; ///< Not executed because the run stopped at the first failure.
+
+    /**
+     * @brief Adds the result of a completed test case to the statistics.
+     */
+    void addTestResult(const TestResult &result);
+
+    /**
+     * @brief Tells if no check failed and no test case was terminated with an exception.
+     */
+    constexpr bool isSuccess() const { return numberOfFailedChecks == 0 && numberOfTestsWithExceptions == 0; }
 };
 
 class TestBase;
 
+/**
+ * @brief Intrusive singly linked list of registered test cases. The link is stored in the test case
+ * itself, so registering a test case during static initialization is O(1) and allocates no memory.
+ */
+class TestList {
+  public:
+    class Iterator {
+      public:
+        using value_type = TestBase *;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        explicit Iterator(TestBase *test) : test_{test} {}
+
+        TestBase *operator*() const { return test_; }
+        Iterator &operator++();
+        Iterator operator++(int) {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const Iterator &) const = default;
+
+      private:
+        TestBase *test_ = nullptr;
+    };
+
+    /**
+     * @brief Links a test case into the end of the list.
+     */
+    void append(TestBase &test);
+
+    Iterator begin() const { return Iterator{first_}; }
+    Iterator end() const { return Iterator{}; }
+    std::size_t size() const { return size_; }
+
+  private:
+    TestBase *first_ = nullptr;
+    TestBase *last_ = nullptr;
+    std::size_t size_ = 0;
+};
+
 /**
  * @brief Implements a simple test framework where test cases can be registered
  * and executed. The results are sent to cout.
@@ -83,29 +230,160 @@ class TestFramework {
      *
      * @param test
      */
-    constexpr void registerTest(TestBase &test) { tests_.push_back(&test); }
+    void registerTest(TestBase &test) { tests_.append(test); }
 
     /**
      * @brief Executes registered test cases.
+     *
+     * @return The exit code of the test run, see executeTests(filter).
+     */
+    int executeTests();
+
+    /**
+     * @brief Executes the registered test cases whose names match the filter.
+     *
+     * @param filter Comma separated list of name patterns where '*' matches any sequence of characters
+     * and '?' any single character. An empty filter matches all test cases.
+     * @return The exit code of the test run: 0 if all executed test cases passed, 1 if a check failed or
+     * a test case was terminated with an exception.
+     */
+    int executeTests(std::string_view filter);
+
+    /**
+     * @brief Tells if a test name matches a filter, see executeTests(filter).
+     */
+    static bool matchesFilter(std::string_view testName, std::string_view filter);
+
+    /**
+     * @brief Executes registered test cases with options given on the command line:
+     *
+     * --update-golden     Rewrite the golden files checked by GCHECK_GOLDEN instead of comparing.
+     * --golden-dir=<dir>  Directory of the golden files, default "golden".
+     * --list-tests        List the registered test cases without executing them.
+     * --list-tests=json   Same as --list-tests but in JSON format.
+     * --filter=<patterns> Only execute the test cases matching the patterns, see executeTests(filter).
+     * --server=<socket>   Stay resident and execute commands received on a Unix socket, see TestServer.
+     * --results-json=<f> Write the result of each test case to a file, one JSON object per line.
+     * --fail-fast         Stop at the first failed test case, see setFailFast().
+     * --timeout=<seconds> Abort the run when a test case runs longer, see setTestTimeout().
+     *
+     * @param argc The number of arguments as given to main().
+     * @param argv The arguments as given to main().
+     * @return The exit code to return from main(), see executeTests(filter). It is 2 if the server could
+     * not be started or the timeout is not a non-negative number of seconds.
+     */
+    int executeTests(int argc, char *argv[]);
+
+    /**
+     * @brief Output formats of listTests().
+     */
+    enum class ListFormat { Plain, Json };
+
+    /**
+     * @brief Lists the registered test cases and where they are defined, without executing them.
+     *
+     * @param os The stream to write the list to.
+     * @param format Plain text with one test case per line, or JSON.
+     */
+    void listTests(std::ostream &os, ListFormat format) const;
+
+    /**
+     * @brief Enables collection of hardware performance counters around each executed test case. If the
+     * counters are not available on the system the tests are executed without them.
+     *
+     * @param enable True to collect performance counters.
      */
-    void executeTests();
+    void enablePerfCounters(bool enable = true);
+
+    /**
+     * @brief Gives the performance counters to use for measurements, or nullptr if performance counters
+     * are disabled or not available.
+     */
+    PerfCounters *getPerfCounters() const;
+
+    /**
+     * @brief Sets the maximum number of failed checks per test case for which details are recorded.
+     * Further failures are only counted and reported as "+N more" in the summary.
+     *
+     * @param maxFailures The maximum number of recorded failures per test case.
+     */
+    constexpr void setMaxRecordedFailures(std::size_t maxFailures) { maxRecordedFailures_ = maxFailures; }
+
+    /**
+     * @brief Get the maximum number of failed checks per test case for which details are recorded.
+     */
+    constexpr std::size_t getMaxRecordedFailures() const { return maxRecordedFailures_; }
+
+    /**
+     * @brief Sets the directory where the golden files of GCHECK_GOLDEN are stored.
+     */
+    void setGoldenDirectory(const std::filesystem::path &directory) { goldenDirectory_ = directory; }
+
+    /**
+     * @brief Get the directory where the golden files of GCHECK_GOLDEN are stored.
+     */
+    const std::filesystem::path &getGoldenDirectory() const { return goldenDirectory_; }
+
+    /**
+     * @brief Makes GCHECK_GOLDEN rewrite the golden files with the checked data instead of comparing.
+     */
+    constexpr void setUpdateGoldenFiles(bool update) { updateGoldenFiles_ = update; }
+
+    /**
+     * @brief Tells if GCHECK_GOLDEN rewrites the golden files instead of comparing.
+     */
+    constexpr bool isUpdatingGoldenFiles() const { return updateGoldenFiles_; }
+
+    /**
+     * @brief Sets a file where the result of each executed test case is written as one JSON object per
+     * line. The file is written as the test cases complete, so it is usable even if the run is aborted.
+     * An empty path disables the results file.
+     */
+    void setResultsFile(const std::filesystem::path &path) { resultsFile_ = path; }
+
+    /**
+     * @brief Makes executeTests() stop at the first test case with a failed check or an exception. The
+     * remaining test cases are counted as skipped.
+     */
+    constexpr void setFailFast(bool failFast) { failFast_ = failFast; }
+
+    /**
+     * @brief Sets the time a test case may run before the process is aborted with its name and last checks,
+     * see TestWatchdog. The timeout is multiplied with Sanitizers::getTimeoutFactor() when the tests run
+     * under sanitizers. A timeout of zero disables it.
+     */
+    void setTestTimeout(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Gives the watchdog enforcing the timeout of the test cases, or nullptr if there is no timeout.
+     */
+    TestWatchdog *getWatchdog() const { return watchdog_.get(); }
+
+    /**
+     * @brief Get the aggregated results of the executed test cases.
+     */
+    constexpr const TestRunStatistics &getStatistics() const { return statistics_; }
 
   private:
     TestFramework() {}
     TestFramework(const TestFramework &) = delete;
 
-    int numberOfExecutedChecks() const;
-    int numberOfFailedChecks() const;
-    auto getPassedTests() const;
-    auto getFailedTests() const;
-    auto getTestsWithExceptions() const;
-    auto getNumberOfExecutedChecks() const;
-
     void printTestSummary() const;
-
-    int numberOfExecutedTests_ = 0;
-    int numberOfFailedTests_ = 0;
-    std::vector<TestBase *> tests_;
+    void printPerfCounters() const;
+    void printUserCounters() const;
+
+    TestRunStatistics statistics_;
+    TestList tests_;
+    std::vector<const TestBase *> failedTests_;
+    std::vector<const TestBase *> testsWithExceptions_;
+    std::vector<const TestBase *> testsWithCounters_;
+    std::unique_ptr<PerfCounters> perfCounters_;
+    std::unique_ptr<TestWatchdog> watchdog_;
+    std::size_t maxRecordedFailures_ = 100;
+    std::filesystem::path goldenDirectory_{"golden"};
+    std::filesystem::path resultsFile_;
+    bool updateGoldenFiles_ = false;
+    bool failFast_ = false;
 };
 
 /**
@@ -118,12 +396,17 @@ class TestBase {
      * @brief Construct a new TestBase object and registers it in the test
      * framework.
      *
-     * @param testName The name of the test case.
+     * @param testName The name of the test case. It is not copied, so only string literals such as the one
+     * given by the GTEST macro are accepted, as they outlive the test case.
      * @param fw A reference to the test framework
+     * @param location Where the test case is defined.
      */
-    TestBase(const std::string &testName, TestFramework &fw) : framework_{fw.getInstance()} {
+    template <std::size_t N>
+    TestBase(const char (&testName)[N], TestFramework &fw,
+             std::source_location location = std::source_location::current())
+        : framework_{fw.getInstance()}, location_{location} {
         framework_.registerTest(*this);
-        testResult_.testName = testName;
+        testResult_.testName = std::string_view{testName};
     }
 
     /**
@@ -140,18 +423,92 @@ class TestBase {
     /**
      * @brief Get the name of the test case.
      */
-    constexpr const std::string &getTestName() const { return testResult_.testName; }
+    constexpr std::string_view getTestName() const { return testResult_.testName; }
+
+    /**
+     * @brief Get the source location where the test case is defined.
+     */
+    constexpr const std::source_location &getLocation() const { return location_; }
 
     /**
      * @brief Get the results of the test case.
      */
     constexpr const TestResult &getTestResult() const { return testResult_; }
 
+    /**
+     * @brief Releases the failure details of the test result when they have been reported.
+     */
+    void releaseFailureRecords() { testResult_.releaseFailureRecords(); }
+
   private:
     TestBase() = delete;
     TestBase(const TestBase &) = delete;
 
+    /**
+     * @brief Counts an executed check and records it in the check trace of the thread.
+     */
+    void beginCheck(const std::source_location &location) {
+        testResult_.numberExecutedChecks++;
+        CheckTrace::recordCheck(location, testResult_.numberExecutedChecks);
+    }
+
+    /**
+     * @brief Counts a failed check and tells if its details shall be recorded.
+     *
+     * @return True if the number of recorded failures is below the limit of the framework.
+     */
+    bool countFailedCheck() {
+        testResult_.numberFailedChecks++;
+        CheckTrace::markLastCheckFailed();
+        return testResult_.failedChecks.size() < framework_.getMaxRecordedFailures();
+    }
+
+    /**
+     * @brief Records a failed check if the size of a result range differs from the expected size.
+     *
+     * @return True if the sizes are equal.
+     */
+    bool checkRangeSizes(const std::string &name, std::size_t resultSize, std::size_t expectedSize);
+
+    /**
+     * @brief Records a failed range check with the first mismatching elements.
+     */
+    template <typename Type, typename Predicate>
+    void recordRangeFailure(const std::string &name, std::span<const Type> result,
+                            std::span<const Type> expected, Predicate matches, std::string_view extraInfo) {
+        if (!countFailedCheck()) {
+            return;
+        }
+
+        std::size_t numberOfMismatches = 0;
+        const auto indices = compare::findMismatches(result.size(), matches, compare::MaxReportedMismatches,
+                                                     numberOfMismatches);
+
+        std::stringstream failMessage;
+        if constexpr (std::floating_point<Type>) {
+            failMessage << std::setprecision(std::numeric_limits<Type>::max_digits10);
+        }
+        failMessage << std::boolalpha << numberOfMismatches << " of " << result.size() << " elements differ";
+        for (auto i : indices) {
+            failMessage << " | [" << i << "] Result: " << result[i] << " Expected: " << expected[i];
+        }
+        failMessage << extraInfo;
+
+        testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+    }
+
+    /**
+     * @brief Records a failed check for each sanitizer which reported findings while the test body ran.
+     */
+    void recordSanitizerFindings(const SanitizerFindings &findingsBefore);
+
+    [[noreturn]] void abortTestBody();
+
+    friend class TestList;
+
     TestFramework &framework_;
+    std::source_location location_;
+    TestBase *nextTest_ = nullptr;
     TestResult testResult_;
 
   protected:
@@ -163,20 +520,51 @@ class TestBase {
      * @tparam Type Any type that has the != opertor.
      * @param result The result from the test.
      * @param expected The expected result of the test.
+     * @return True if the check passed.
      */
-    template <typename Type> constexpr void GCHECK(const std::string &name, Type result, Type expected) {
-        testResult_.numberExecutedChecks++;
+    template <typename Type>
+    constexpr bool GCHECK(const std::string &name, Type result, Type expected,
+                          std::source_location location = std::source_location::current()) {
+        beginCheck(location);
 
         if (result != expected) {
-            std::stringstream failMessage;
-            failMessage << std::boolalpha << "Result: " << result << " | Expected: " << expected;
-            testResult_.failedChecks.emplace_back(
-                FailedCheck{testResult_.numberExecutedChecks, name, failMessage.str()});
+            if (countFailedCheck()) {
+                std::stringstream failMessage;
+                failMessage << std::boolalpha << "Result: " << result << " | Expected: " << expected;
+                testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+            }
+            return false;
         }
+
+        return true;
     }
 
-    template <typename Type> constexpr void GCHECK(Type result, Type expected) {
-        GCHECK(std::string{""}, result, expected);
+    template <typename Type>
+    constexpr bool GCHECK(Type result, Type expected,
+                          std::source_location location = std::source_location::current()) {
+        return GCHECK(std::string{""}, result, expected, location);
+    }
+
+    /**
+     * @brief Same as GCHECK but aborts the test body if the check fails. Use it for preconditions where
+     * continuing the test after a failure is meaningless.
+     *
+     * @tparam Type Any type that has the != opertor.
+     * @param result The result from the test.
+     * @param expected The expected result of the test.
+     */
+    template <typename Type>
+    constexpr void GASSERT(const std::string &name, Type result, Type expected,
+                           std::source_location location = std::source_location::current()) {
+        if (!GCHECK(name, result, expected, location)) {
+            abortTestBody();
+        }
+    }
+
+    template <typename Type>
+    constexpr void GASSERT(Type result, Type expected,
+                           std::source_location location = std::source_location::current()) {
+        GASSERT(std::string{""}, result, expected, location);
     }
 
     /**
@@ -188,20 +576,278 @@ class TestBase {
      * @param tolerance The expected tolerance.
      */
     template <typename Type>
-    constexpr void GCHECKT(const std::string &name, Type result, Type expected, Type tolerance) {
-        testResult_.numberExecutedChecks++;
+    constexpr bool GCHECKT(const std::string &name, Type result, Type expected, Type tolerance,
+                           std::source_location location = std::source_location::current()) {
+        beginCheck(location);
 
         if ((result < (expected - tolerance / 2)) || (result > (expected + tolerance / 2))) {
-            std::stringstream failMessage;
-            failMessage << std::boolalpha << "Result: " << result << " | Expected: " << expected
-                        << " | Tolerance: " << tolerance;
-            ;
-            testResult_.failedChecks.emplace_back(
-                FailedCheck{testResult_.numberExecutedChecks, name, failMessage.str()});
+            if (countFailedCheck()) {
+                std::stringstream failMessage;
+                failMessage << std::boolalpha << "Result: " << result << " | Expected: " << expected
+                            << " | Tolerance: " << tolerance;
+                testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Same as GCHECKT but aborts the test body if the check fails.
+     */
+    template <typename Type>
+    constexpr void GASSERTT(const std::string &name, Type result, Type expected, Type tolerance,
+                            std::source_location location = std::source_location::current()) {
+        if (!GCHECKT(name, result, expected, tolerance, location)) {
+            abortTestBody();
+        }
+    }
+
+    /**
+     * @brief Performs a check to see that two contiguous ranges (arrays, vectors, spans etc.) have the
+     * same size and equal elements. The whole range counts as one check.
+     *
+     * The ranges are compared in bulk; only if they differ are the first differing indices located and
+     * reported.
+     *
+     * @param result The result from the test.
+     * @param expected The expected result of the test.
+     * @return True if the check passed.
+     */
+    template <typename ResultRange, typename ExpectedRange>
+        requires compare::ComparableRanges<ResultRange, ExpectedRange>
+    constexpr bool GCHECK_RANGE(const std::string &name, const ResultRange &result,
+                                const ExpectedRange &expected,
+                                std::source_location location = std::source_location::current()) {
+        using Type = std::ranges::range_value_t<ResultRange>;
+        const std::span<const Type> resultSpan{result};
+        const std::span<const Type> expectedSpan{expected};
+
+        beginCheck(location);
+
+        if (!checkRangeSizes(name, resultSpan.size(), expectedSpan.size())) {
+            return false;
         }
+        if (compare::allEqual(resultSpan, expectedSpan)) {
+            return true;
+        }
+
+        recordRangeFailure(name, resultSpan, expectedSpan,
+                           [&](std::size_t i) { return resultSpan[i] == expectedSpan[i]; }, "");
+        return false;
+    }
+
+    template <typename ResultRange, typename ExpectedRange>
+        requires compare::ComparableRanges<ResultRange, ExpectedRange>
+    constexpr bool GCHECK_RANGE(const ResultRange &result, const ExpectedRange &expected,
+                                std::source_location location = std::source_location::current()) {
+        return GCHECK_RANGE(std::string{""}, result, expected, location);
+    }
+
+    /**
+     * @brief Performs a check to see that two contiguous ranges have the same size and that each element
+     * is within +/- tolerance/2 from the expected element, see GCHECKT. The whole range counts as one
+     * check.
+     *
+     * @param result The result from the test.
+     * @param expected The expected result of the test.
+     * @param tolerance The expected tolerance.
+     * @return True if the check passed.
+     */
+    template <typename ResultRange, typename ExpectedRange>
+        requires compare::ComparableRanges<ResultRange, ExpectedRange>
+    constexpr bool GCHECK_ARRAY_NEAR(const std::string &name, const ResultRange &result,
+                                     const ExpectedRange &expected,
+                                     std::ranges::range_value_t<ResultRange> tolerance,
+                                     std::source_location location = std::source_location::current()) {
+        using Type = std::ranges::range_value_t<ResultRange>;
+        const std::span<const Type> resultSpan{result};
+        const std::span<const Type> expectedSpan{expected};
+        const auto matches = [&](std::size_t i) {
+            return compare::isNear(resultSpan[i], expectedSpan[i], tolerance);
+        };
+
+        beginCheck(location);
+
+        if (!checkRangeSizes(name, resultSpan.size(), expectedSpan.size())) {
+            return false;
+        }
+        if (compare::allOf(resultSpan.size(), matches)) {
+            return true;
+        }
+
+        std::stringstream toleranceText;
+        toleranceText << " | Tolerance: " << tolerance;
+        recordRangeFailure(name, resultSpan, expectedSpan, matches, toleranceText.view());
+        return false;
+    }
+
+    /**
+     * @brief Performs a check to see that a floating point result is at most maxUlps units in the last
+     * place (ULP) from the expected value. Unlike GCHECKT the allowed difference scales with the
+     * magnitude of the values.
+     *
+     * @param result The result from the test.
+     * @param expected The expected result of the test.
+     * @param maxUlps The maximum allowed distance in ULPs.
+     * @return True if the check passed.
+     */
+    template <std::floating_point Type>
+    constexpr bool GCHECK_ULP(const std::string &name, Type result, Type expected, std::uint64_t maxUlps,
+                              std::source_location location = std::source_location::current()) {
+        beginCheck(location);
+
+        if (!compare::isWithinUlps(result, expected, maxUlps)) {
+            if (countFailedCheck()) {
+                std::stringstream failMessage;
+                failMessage << std::setprecision(std::numeric_limits<Type>::max_digits10);
+                failMessage << "Result: " << result << " | Expected: " << expected
+                            << " | ULP distance: " << compare::ulpDistance(result, expected)
+                            << " | Max ULPs: " << maxUlps;
+                testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Performs a check to see that a floating point result is within a relative tolerance from
+     * the expected value, i.e. |result - expected| <= relativeTolerance * max(|result|, |expected|).
+     *
+     * @param result The result from the test.
+     * @param expected The expected result of the test.
+     * @param relativeTolerance The allowed relative difference, e.g. 1e-6.
+     * @return True if the check passed.
+     */
+    template <std::floating_point Type>
+    constexpr bool GCHECK_REL(const std::string &name, Type result, Type expected, Type relativeTolerance,
+                              std::source_location location = std::source_location::current()) {
+        beginCheck(location);
+
+        if (!compare::isRelativelyNear(result, expected, relativeTolerance)) {
+            if (countFailedCheck()) {
+                std::stringstream failMessage;
+                failMessage << std::setprecision(std::numeric_limits<Type>::max_digits10);
+                failMessage << "Result: " << result << " | Expected: " << expected
+                            << " | Relative tolerance: " << relativeTolerance;
+                testResult_.addFailedCheck(testResult_.numberExecutedChecks, name, failMessage.view());
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Performs a check to see that the data is equal to the contents of a golden file. The golden
+     * file is memory mapped and compared without copying. On mismatch the offset of the first differing
+     * byte is reported.
+     *
+     * When the framework updates golden files (--update-golden) the golden file is instead replaced with
+     * the data and the check passes.
+     *
+     * @param name The name of the golden file, relative to the golden file directory of the framework.
+     * @param bytes The data produced by the test.
+     * @return True if the check passed.
+     */
+    bool GCHECK_GOLDEN(const std::string &name, std::span<const std::byte> bytes,
+                       std::source_location location = std::source_location::current());
+
+    bool GCHECK_GOLDEN(const std::string &name, std::string_view text,
+                       std::source_location location = std::source_location::current()) {
+        return GCHECK_GOLDEN(name, std::as_bytes(std::span{text.data(), text.size()}), location);
+    }
+
+    /**
+     * @brief Range version of GCHECK_ULP. The whole range counts as one check.
+     */
+    template <typename ResultRange, typename ExpectedRange>
+        requires compare::ComparableRanges<ResultRange, ExpectedRange> &&
+                 std::floating_point<std::ranges::range_value_t<ResultRange>>
+    constexpr bool GCHECK_RANGE_ULP(const std::string &name, const ResultRange &result,
+                                    const ExpectedRange &expected, std::uint64_t maxUlps,
+                                    std::source_location location = std::source_location::current()) {
+        using Type = std::ranges::range_value_t<ResultRange>;
+        const std::span<const Type> resultSpan{result};
+        const std::span<const Type> expectedSpan{expected};
+        const auto matches = [&](std::size_t i) {
+            return compare::isWithinUlps(resultSpan[i], expectedSpan[i], maxUlps);
+        };
+
+        beginCheck(location);
+
+        if (!checkRangeSizes(name, resultSpan.size(), expectedSpan.size())) {
+            return false;
+        }
+        if (compare::allOf(resultSpan.size(), matches)) {
+            return true;
+        }
+
+        std::stringstream ulpText;
+        ulpText << " | Max ULPs: " << maxUlps;
+        recordRangeFailure(name, resultSpan, expectedSpan, matches, ulpText.view());
+        return false;
+    }
+
+    /**
+     * @brief Range version of GCHECK_REL. The whole range counts as one check.
+     */
+    template <typename ResultRange, typename ExpectedRange>
+        requires compare::ComparableRanges<ResultRange, ExpectedRange> &&
+                 std::floating_point<std::ranges::range_value_t<ResultRange>>
+    constexpr bool GCHECK_RANGE_REL(const std::string &name, const ResultRange &result,
+                                    const ExpectedRange &expected,
+                                    std::ranges::range_value_t<ResultRange> relativeTolerance,
+                                    std::source_location location = std::source_location::current()) {
+        using Type = std::ranges::range_value_t<ResultRange>;
+        const std::span<const Type> resultSpan{result};
+        const std::span<const Type> expectedSpan{expected};
+        const auto matches = [&](std::size_t i) {
+            return compare::isRelativelyNear(resultSpan[i], expectedSpan[i], relativeTolerance);
+        };
+
+        beginCheck(location);
+
+        if (!checkRangeSizes(name, resultSpan.size(), expectedSpan.size())) {
+            return false;
+        }
+        if (compare::allOf(resultSpan.size(), matches)) {
+            return true;
+        }
+
+        std::stringstream toleranceText;
+        toleranceText << " | Relative tolerance: " << relativeTolerance;
+        recordRangeFailure(name, resultSpan, expectedSpan, matches, toleranceText.view());
+        return false;
+    }
+
+    /**
+     * @brief Adds a value to a named counter which is reported with the result of the test case, e.g.
+     * addCounter("bytes", size, CounterKind::Rate) to report the bytes processed per second.
+     */
+    void addCounter(std::string_view name, double value, CounterKind kind = CounterKind::Total) {
+        testResult_.counters.add(name, value, kind);
     }
 };
 
+inline TestList::Iterator &TestList::Iterator::operator++() {
+    test_ = test_->nextTest_;
+    return *this;
+}
+
+inline void TestList::append(TestBase &test) {
+    if (last_ == nullptr) {
+        first_ = &test;
+    } else {
+        last_->nextTest_ = &test;
+    }
+    last_ = &test;
+    ++size_;
+}
+
 /**
  * @def GTEST(TestName)
  * @brief This macro creates a test case instance. The body of the test is
@@ -229,7 +875,7 @@ class TestBase {
 #define GTEST(TestName)                                                                                      \
     class TestName##Test : public gtest::TestBase {                                                          \
       public:                                                                                                \
-        TestName##Test(const std::string &n, gtest::TestFramework &fw) : TestBase{n, fw} {}                  \
+        TestName##Test(const char (&n)[sizeof(#TestName)], gtest::TestFramework &fw) : TestBase{n, fw} {}    \
                                                                                                              \
         void testBody() override;                                                                            \
     };                                                                                                       \
@@ -0,0 +1,225 @@
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+#if __has_include(<sys/un.h>)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define GTEST_HAS_UNIX_SOCKETS 1
+#endif
+
+#include "g_test_framework.hpp"
+#include "g_test_server.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+#if defined(GTEST_HAS_UNIX_SOCKETS)
+
+namespace {
+
+/**
+ * @brief Stream buffer which sends everything written to it to a socket.
+ */
+class SocketStreamBuffer : public streambuf {
+  public:
+    explicit SocketStreamBuffer(int fd) : fd_{fd} { setp(buffer_.data(), buffer_.data() + buffer_.size()); }
+    ~SocketStreamBuffer() override { sync(); }
+
+  protected:
+    int_type overflow(int_type c) override {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        const char *data = pbase();
+        auto remaining = static_cast<size_t>(pptr() - pbase());
+
+        while (remaining > 0) {
+            const auto sent = send(fd_, data, remaining, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return -1;
+            }
+            data += sent;
+            remaining -= static_cast<size_t>(sent);
+        }
+
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return 0;
+    }
+
+  private:
+    int fd_;
+    array<char, 4096> buffer_{};
+};
+
+/**
+ * @brief Redirects cout to a socket for the lifetime of the object.
+ */
+class CoutRedirection {
+  public:
+    explicit CoutRedirection(int fd) : buffer_{fd}, savedBuffer_{cout.rdbuf(&buffer_)} {}
+    ~CoutRedirection() {
+        cout.flush();
+        cout.rdbuf(savedBuffer_);
+    }
+
+    CoutRedirection(const CoutRedirection &) = delete;
+    CoutRedirection &operator=(const CoutRedirection &) = delete;
+
+  private:
+    SocketStreamBuffer buffer_;
+    streambuf *savedBuffer_;
+};
+
+pair<string_view, string_view> splitCommand(string_view line) {
+    const auto space = line.find(' ');
+    if (space == string_view::npos) {
+        return {line, {}};
+    }
+    return {line.substr(0, space), line.substr(space + 1)};
+}
+
+/**
+ * @brief Removes a socket left behind by an earlier server. Any other kind of file at the path is kept, as
+ * it is more likely a mistyped --server path than a socket.
+ *
+ * @return True if there is no file at the path any more.
+ */
+bool removeSocketFile(const string &path) {
+    struct stat status{};
+    if (lstat(path.c_str(), &status) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(status.st_mode)) {
+        cerr << path << " exists and is not a socket, it is not replaced." << endl;
+        return false;
+    }
+    return unlink(path.c_str()) == 0;
+}
+
+} // namespace
+
+#endif
+
+TestServer::TestServer(TestFramework &framework, const filesystem::path &socketPath)
+    : framework_{framework}, socketPath_{socketPath} {}
+
+bool TestServer::run() {
+#if defined(GTEST_HAS_UNIX_SOCKETS)
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const auto path = socketPath_.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path too long: " << path << endl;
+        return false;
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    const int serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverFd == -1) {
+        cerr << "Could not create socket: " << strerror(errno) << endl;
+        return false;
+    }
+
+    if (!removeSocketFile(path)) {
+        close(serverFd);
+        return false;
+    }
+    if (bind(serverFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(serverFd, 1) != 0) {
+        cerr << "Could not listen on " << path << ": " << strerror(errno) << endl;
+        close(serverFd);
+        return false;
+    }
+
+    cout << "Test server listening on " << path << endl;
+
+    while (!isShutdownRequested_) {
+        const int clientFd = accept(serverFd, nullptr, nullptr);
+        if (clientFd == -1) {
+            // A client which gave up while being accepted is no reason to stop, but other errors such as
+            // running out of file descriptors would repeat forever.
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            cerr << "Could not accept a connection on " << path << ": " << strerror(errno) << endl;
+            close(serverFd);
+            removeSocketFile(path);
+            return false;
+        }
+
+        string pending;
+        array<char, 1024> buffer{};
+        bool isConnected = true;
+
+        while (isConnected) {
+            const auto received = recv(clientFd, buffer.data(), buffer.size(), 0);
+            if (received <= 0) {
+                break;
+            }
+            pending.append(buffer.data(), static_cast<size_t>(received));
+
+            for (auto newline = pending.find('\n'); isConnected && newline != string::npos;
+                 newline = pending.find('\n')) {
+                auto line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                isConnected = executeCommand(clientFd, line);
+            }
+        }
+
+        close(clientFd);
+    }
+
+    close(serverFd);
+    removeSocketFile(path);
+    return true;
+#else
+    cerr << "Server mode is not supported on this platform." << endl;
+    return false;
+#endif
+}
+
+bool TestServer::executeCommand([[maybe_unused]] int clientFd, [[maybe_unused]] string_view command) {
+#if defined(GTEST_HAS_UNIX_SOCKETS)
+    const auto [name, argument] = splitCommand(command);
+    CoutRedirection redirection(clientFd);
+
+    if (name == "run") {
+        framework_.executeTests(argument);
+    } else if (name == "list") {
+        framework_.listTests(cout, argument == "json" ? TestFramework::ListFormat::Json
+                                                      : TestFramework::ListFormat::Plain);
+    } else if (name == "quit") {
+        return false;
+    } else if (name == "shutdown") {
+        isShutdownRequested_ = true;
+        return false;
+    } else if (!name.empty()) {
+        cout << "Unknown command: " << name << endl;
+    }
+#endif
+
+    return true;
+}
+
+} // namespace gtest
@@ -0,0 +1,63 @@
+/**
+ * @file g_test_server.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Server mode where a test binary stays resident and executes tests on request.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <filesystem>
+#include <string_view>
+
+#pragma once
+
+namespace gtest {
+
+class TestFramework;
+
+/**
+ * @brief Keeps the test binary resident and executes commands received on a Unix domain socket. This
+ * avoids process startup and static initialization when tests are executed repeatedly, and lets
+ * resources set up by earlier test runs be reused.
+ *
+ * Clients send one command per line and receive the output of the command streamed back:
+ *
+ * - run [filter]      Executes the test cases matching the filter (all if omitted).
+ * - list [json]       Lists the registered test cases.
+ * - quit              Closes the connection.
+ * - shutdown          Closes the connection and stops the server.
+ *
+ * Example using socat:
+ * @code
+ * ./run_tests --server=/tmp/tests.sock &
+ * echo "run Parser*" | socat - UNIX-CONNECT:/tmp/tests.sock
+ * @endcode
+ */
+class TestServer {
+  public:
+    TestServer(TestFramework &framework, const std::filesystem::path &socketPath);
+
+    /**
+     * @brief Serves clients, one at a time, until a shutdown command is received.
+     *
+     * @return True if the server stopped because of a shutdown command, false if it could not be started.
+     */
+    bool run();
+
+  private:
+    /**
+     * @brief Executes a command from a client with its output redirected to the client.
+     *
+     * @return False if the connection shall be closed.
+     */
+    bool executeCommand(int clientFd, std::string_view command);
+
+    TestFramework &framework_;
+    std::filesystem::path socketPath_;
+    bool isShutdownRequested_ = false;
+};
+
+} // namespace gtest
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+// winpthreads has pthread_kill() but does not deliver signals with it, so Windows aborts directly.
+#if !defined(_WIN32) && __has_include(<pthread.h>)
+#include <pthread.h>
+#define GTEST_HAS_PTHREADS 1
+#endif
+
+#include "g_test_watchdog.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+TestWatchdog::TestWatchdog(chrono::nanoseconds timeout) : timeout_(timeout), thread_([this] { watch(); }) {}
+
+TestWatchdog::~TestWatchdog() {
+    {
+        lock_guard lock(mutex_);
+        isStopping_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+}
+
+void TestWatchdog::start(string_view testName) {
+    {
+        lock_guard lock(mutex_);
+        deadline_ = chrono::steady_clock::now() + timeout_;
+        testName_ = testName;
+#if defined(GTEST_HAS_PTHREADS)
+        testThread_ = pthread_self();
+#endif
+    }
+    condition_.notify_one();
+}
+
+void TestWatchdog::stop() {
+    lock_guard lock(mutex_);
+    deadline_.reset();
+}
+
+void TestWatchdog::watch() {
+    unique_lock lock(mutex_);
+
+    while (!isStopping_) {
+        if (!deadline_) {
+            condition_.wait(lock);
+        } else if (condition_.wait_until(lock, *deadline_) == cv_status::timeout && deadline_ &&
+                   chrono::steady_clock::now() >= *deadline_) {
+            cerr << "\n*** Test case " << testName_ << " timed out after "
+                 << chrono::duration<double>(timeout_).count() << " s ***" << endl;
+
+#if defined(GTEST_HAS_PTHREADS)
+            // Abort on the thread of the test case, so that the crash handler writes its last checks.
+            pthread_kill(testThread_, SIGABRT);
+            deadline_.reset();
+#else
+            abort();
+#endif
+        }
+    }
+}
+
+} // namespace gtest
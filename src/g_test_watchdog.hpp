@@ -0,0 +1,75 @@
+/**
+ * @file g_test_watchdog.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Timeout of the test cases, enforced by a watchdog thread.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Aborts the process when a test case runs longer than the timeout.
+ *
+ * A hanging test case would otherwise block the rest of the run until an outer timeout, e.g. of the CI
+ * job, kills the process without telling which test case hung. The watchdog instead writes the name of the
+ * test case and aborts it on its own thread, so that the crash handler of CheckTrace writes the last checks
+ * made before it hung.
+ */
+class TestWatchdog {
+  public:
+    /**
+     * @brief Starts the watchdog thread.
+     *
+     * @param timeout The time a test case may run.
+     */
+    explicit TestWatchdog(std::chrono::nanoseconds timeout);
+
+    /**
+     * @brief Stops the watchdog thread.
+     */
+    ~TestWatchdog();
+
+    TestWatchdog(const TestWatchdog &) = delete;
+    TestWatchdog &operator=(const TestWatchdog &) = delete;
+
+    /**
+     * @brief Starts the timeout of a test case executed by the calling thread.
+     *
+     * @param testName The name of the test case. It is not copied and must outlive the test case.
+     */
+    void start(std::string_view testName);
+
+    /**
+     * @brief Stops the timeout of the test case.
+     */
+    void stop();
+
+    std::chrono::nanoseconds getTimeout() const { return timeout_; }
+
+  private:
+    void watch();
+
+    std::chrono::nanoseconds timeout_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
+    std::string_view testName_;
+    std::thread::native_handle_type testThread_{};
+    bool isStopping_{false};
+    std::thread thread_; // Started last, when the members it uses are initialized.
+};
+
+} // namespace gtest
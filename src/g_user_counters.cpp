@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "g_user_counters.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+ostream &operator<<(ostream &os, CounterKind kind) {
+    switch (kind) {
+    case CounterKind::Rate:
+        return os << "rate";
+    case CounterKind::Average:
+        return os << "average";
+    default:
+        return os << "total";
+    }
+}
+
+void UserCounters::add(string_view name, double value, CounterKind kind) {
+    auto counter = ranges::find(counters_, name, &UserCounter::name);
+    if (counter == counters_.end()) {
+        counters_.push_back(UserCounter{.name = string{name}, .kind = kind});
+        counter = counters_.end() - 1;
+    }
+
+    counter->sum += value;
+    ++counter->numberOfValues;
+}
+
+void UserCounters::merge(const UserCounters &other) {
+    for (const auto &otherCounter : other.counters_) {
+        auto counter = ranges::find(counters_, otherCounter.name, &UserCounter::name);
+        if (counter == counters_.end()) {
+            counters_.push_back(otherCounter);
+        } else {
+            counter->sum += otherCounter.sum;
+            counter->numberOfValues += otherCounter.numberOfValues;
+        }
+    }
+}
+
+void UserCounters::resolve(chrono::nanoseconds measuredTime, int64_t numberOfIterations) {
+    const auto seconds = chrono::duration<double>(measuredTime).count();
+
+    for (auto &counter : counters_) {
+        switch (counter.kind) {
+        case CounterKind::Rate:
+            counter.value = seconds > 0.0 ? counter.sum / seconds : 0.0;
+            break;
+        case CounterKind::Average: {
+            const auto divisor = numberOfIterations > 0 ? numberOfIterations : counter.numberOfValues;
+            counter.value = divisor > 0 ? counter.sum / static_cast<double>(divisor) : 0.0;
+            break;
+        }
+        default:
+            counter.value = counter.sum;
+            break;
+        }
+    }
+}
+
+string counterValueText(const UserCounter &counter) {
+    constexpr array<string_view, 5> prefixes{"", "k", "M", "G", "T"};
+
+    // Scale large values with SI prefixes so that they fit in a table column.
+    auto value = counter.value;
+    size_t prefix{0};
+    while (abs(value) >= 1000.0 && prefix + 1 < prefixes.size()) {
+        value /= 1000.0;
+        ++prefix;
+    }
+
+    stringstream text;
+    text << fixed << setprecision(value == trunc(value) && prefix == 0 ? 0 : 2) << value << prefixes[prefix];
+    if (counter.kind == CounterKind::Rate) {
+        text << "/s";
+    }
+    return text.str();
+}
+
+} // namespace gtest
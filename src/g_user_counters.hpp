@@ -0,0 +1,90 @@
+/**
+ * @file g_user_counters.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Named counters reported by tests and benchmarks alongside their timings.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief How the values added to a counter are reported.
+ */
+enum class CounterKind {
+    Total,   ///< The sum of the added values, e.g. bytes processed.
+    Rate,    ///< The sum per second of the measured time, e.g. bytes per second.
+    Average, ///< The sum per iteration of a benchmark, or the mean of the added values in a test case.
+};
+
+std::ostream &operator<<(std::ostream &os, CounterKind kind);
+
+/**
+ * @brief A named counter and the values added to it.
+ */
+struct UserCounter {
+    std::string name;
+    CounterKind kind{CounterKind::Total};
+    double sum{0.0};
+    std::int64_t numberOfValues{0};
+    double value{0.0}; ///< The reported value, see UserCounters::resolve().
+};
+
+/**
+ * @brief The counters of a test case or benchmark, in the order they were first added.
+ *
+ * A test or benchmark has few counters, so they are kept in a vector which is searched linearly and
+ * allocates only when a name is added for the first time. The counters are not synchronized: each thread
+ * of a multithreaded benchmark adds to the counters of its own BenchmarkState, and they are merged when
+ * the threads are joined.
+ */
+class UserCounters {
+  public:
+    /**
+     * @brief Adds a value to a counter, creating the counter if it does not exist. The kind is taken from
+     * the first value added to the counter.
+     */
+    void add(std::string_view name, double value, CounterKind kind = CounterKind::Total);
+
+    /**
+     * @brief Adds the values of the counters of another instance.
+     */
+    void merge(const UserCounters &other);
+
+    /**
+     * @brief Computes the reported value of each counter.
+     *
+     * @param measuredTime The time the rates are computed over.
+     * @param numberOfIterations The number of iterations averages are computed over, or 0 to average over
+     * the number of added values.
+     */
+    void resolve(std::chrono::nanoseconds measuredTime, std::int64_t numberOfIterations = 0);
+
+    void clear() { counters_.clear(); }
+    bool empty() const { return counters_.empty(); }
+
+    auto begin() const { return counters_.begin(); }
+    auto end() const { return counters_.end(); }
+
+  private:
+    std::vector<UserCounter> counters_;
+};
+
+/**
+ * @brief Formats the reported value of a counter for the result tables, e.g. "1.25G/s" for a rate.
+ */
+std::string counterValueText(const UserCounter &counter);
+
+} // namespace gtest
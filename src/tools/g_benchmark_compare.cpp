@@ -0,0 +1,359 @@
+/**
+ * @file g_benchmark_compare.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Compares two benchmark results files and reports significant changes.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ * The results files are written by --results-json of a benchmark binary. Benchmarks are matched by name,
+ * range argument, number of threads and cache mode. A change is significant when Welch's t-test, computed
+ * from the mean, standard deviation and number of batches of each result, rejects equal means.
+ */
+
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "g_print_table.hpp"
+#include "g_test_report.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+struct Options {
+    double thresholdPercent{5.0};
+    double alpha{0.05};
+    filesystem::path baselineFile;
+    filesystem::path candidateFile;
+};
+
+struct Measurement {
+    double mean{0.0};
+    double standardDeviation{0.0};
+    double numberOfBatches{0.0};
+    bool hasError{false};
+};
+
+void printUsage() {
+    cout << "Usage: gtest_compare [options] <baseline results> <candidate results>" << endl;
+    cout << endl;
+    cout << "Options:" << endl;
+    cout << "  --threshold=<percent>  Smallest change reported as faster or slower, default 5." << endl;
+    cout << "  --alpha=<p>            Significance level of the t-test, default 0.05." << endl;
+}
+
+/**
+ * @brief Parses the value of an option as a finite number.
+ */
+optional<double> parseNumber(string_view text) {
+    double value{0.0};
+    const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    if (error != errc{} || end != text.data() + text.size() || !isfinite(value)) {
+        return nullopt;
+    }
+    return value;
+}
+
+optional<Options> parseOptions(int argc, char *argv[]) {
+    Options options;
+    vector<filesystem::path> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const string_view argument{argv[i]};
+        const auto value = argument.substr(argument.find('=') + 1);
+
+        if (argument.starts_with("--threshold=")) {
+            const auto thresholdPercent = parseNumber(value);
+            if (!thresholdPercent || *thresholdPercent < 0.0) {
+                cerr << "Invalid threshold: " << value << endl;
+                return nullopt;
+            }
+            options.thresholdPercent = *thresholdPercent;
+        } else if (argument.starts_with("--alpha=")) {
+            const auto alpha = parseNumber(value);
+            if (!alpha || *alpha <= 0.0 || *alpha >= 1.0) {
+                cerr << "Invalid significance level: " << value << endl;
+                return nullopt;
+            }
+            options.alpha = *alpha;
+        } else if (argument.starts_with("--")) {
+            cerr << "Unknown option: " << argument << endl;
+            return nullopt;
+        } else {
+            files.emplace_back(argument);
+        }
+    }
+
+    if (files.size() != 2) {
+        return nullopt;
+    }
+
+    options.baselineFile = files[0];
+    options.candidateFile = files[1];
+    return options;
+}
+
+/**
+ * @brief Gives the key benchmarks are matched by, e.g. "Sort/512/threads:4/cold".
+ */
+string benchmarkKey(const JsonValue &record) {
+    string key{record.stringAt("name")};
+    if (const auto *range = record.find("range"); range != nullptr && !range->isNull()) {
+        key += "/" + to_string(static_cast<long long>(range->asNumber()));
+    }
+    if (const auto *threads = record.find("threads"); threads != nullptr && !threads->isNull()) {
+        key += "/threads:" + to_string(static_cast<long long>(threads->asNumber()));
+    }
+    if (const auto *cacheMode = record.find("cacheMode"); cacheMode != nullptr && !cacheMode->isNull()) {
+        key += "/" + string{cacheMode->asString()};
+    }
+    return key;
+}
+
+/**
+ * @brief Reads the result records of a results file in file order.
+ */
+optional<vector<pair<string, Measurement>>> readResults(const filesystem::path &path) {
+    vector<pair<string, Measurement>> results;
+
+    const auto isRead = forEachJsonLine(path, [&](const JsonValue &record, string_view) {
+        if (record.stringAt("type") != "result") {
+            return;
+        }
+
+        const auto *error = record.find("error");
+        results.emplace_back(benchmarkKey(record),
+                             Measurement{.mean = record.numberAt("meanNs"),
+                                         .standardDeviation = record.numberAt("stddevNs"),
+                                         .numberOfBatches = record.numberAt("batches"),
+                                         .hasError = error != nullptr && !error->isNull()});
+    });
+
+    if (!isRead) {
+        cerr << "Could not read " << path.string() << endl;
+        return nullopt;
+    }
+    return results;
+}
+
+/**
+ * @brief Continued fraction of the regularized incomplete beta function, evaluated with the modified Lentz
+ * method.
+ */
+double incompleteBetaFraction(double a, double b, double x) {
+    constexpr int MaxIterations{200};
+    constexpr double Epsilon{1e-12};
+    constexpr double Tiny{1e-300};
+
+    const auto guard = [](double value) { return abs(value) < Tiny ? Tiny : value; };
+
+    double c{1.0};
+    double d = 1.0 / guard(1.0 - (a + b) * x / (a + 1.0));
+    double fraction{d};
+
+    for (int m = 1; m <= MaxIterations; ++m) {
+        const double m2 = 2.0 * m;
+
+        const double evenStep = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+        d = 1.0 / guard(1.0 + evenStep * d);
+        c = guard(1.0 + evenStep / c);
+        fraction *= d * c;
+
+        const double oddStep = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+        d = 1.0 / guard(1.0 + oddStep * d);
+        c = guard(1.0 + oddStep / c);
+        const double delta = d * c;
+        fraction *= delta;
+
+        if (abs(delta - 1.0) < Epsilon) {
+            break;
+        }
+    }
+
+    return fraction;
+}
+
+/**
+ * @brief Gives the regularized incomplete beta function I_x(a, b).
+ */
+double regularizedIncompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    if (x >= 1.0) {
+        return 1.0;
+    }
+
+    const double logFront = lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x);
+    const double front = exp(logFront);
+
+    // The continued fraction converges fast for x < (a + 1) / (a + b + 2), otherwise the symmetry
+    // I_x(a, b) = 1 - I_(1-x)(b, a) is used.
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * incompleteBetaFraction(a, b, x) / a;
+    }
+    return 1.0 - front * incompleteBetaFraction(b, a, 1.0 - x) / b;
+}
+
+/**
+ * @brief Gives the two sided p-value of Welch's t-test for equal means, or empty if it cannot be computed,
+ * e.g. with a single batch or no variance.
+ */
+optional<double> welchTTest(const Measurement &baseline, const Measurement &candidate) {
+    if (baseline.numberOfBatches < 2 || candidate.numberOfBatches < 2) {
+        return nullopt;
+    }
+
+    // The squared standard errors of the means.
+    const double baselineVariance =
+        baseline.standardDeviation * baseline.standardDeviation / baseline.numberOfBatches;
+    const double candidateVariance =
+        candidate.standardDeviation * candidate.standardDeviation / candidate.numberOfBatches;
+    const double variance = baselineVariance + candidateVariance;
+    if (variance <= 0.0) {
+        return nullopt;
+    }
+
+    const double t = (candidate.mean - baseline.mean) / sqrt(variance);
+    const double degreesOfFreedom =
+        variance * variance / (baselineVariance * baselineVariance / (baseline.numberOfBatches - 1) +
+                               candidateVariance * candidateVariance / (candidate.numberOfBatches - 1));
+
+    // The two sided tail probability of Student's t distribution.
+    const double x = degreesOfFreedom / (degreesOfFreedom + t * t);
+    return regularizedIncompleteBeta(degreesOfFreedom / 2.0, 0.5, x);
+}
+
+string significanceMarker(optional<double> pValue) {
+    if (!pValue) {
+        return "";
+    }
+    if (*pValue < 0.001) {
+        return "***";
+    }
+    if (*pValue < 0.01) {
+        return "**";
+    }
+    if (*pValue < 0.05) {
+        return "*";
+    }
+    return "";
+}
+
+string formatNumber(double value, int precision) {
+    stringstream text;
+    text << fixed << setprecision(precision) << value;
+    return text.str();
+}
+
+} // namespace
+
+/**
+ * @brief Runs the comparison tool.
+ *
+ * @return The exit code of the tool: 0 if no benchmark became significantly slower, 1 if some did and 2
+ * if the results files could not be read.
+ */
+int runBenchmarkCompare(int argc, char *argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        printUsage();
+        return 2;
+    }
+
+    const auto baselineResults = readResults(options->baselineFile);
+    const auto candidateResults = readResults(options->candidateFile);
+    if (!baselineResults || !candidateResults) {
+        return 2;
+    }
+
+    map<string, Measurement, less<>> baseline(baselineResults->begin(), baselineResults->end());
+
+    const vector<int> compareTableColumnWidths{4, 30, 14, 14, 12, 10, 10};
+    constexpr auto changeColumn{4};
+    constexpr auto resultColumn{6};
+    const auto defaultColors = vector<string>(compareTableColumnWidths.size(), PrintColor::Reset);
+    printTableRow(compareTableColumnWidths, defaultColors, "#", "Benchmark", "Baseline [ns]",
+                  "Candidate [ns]", "Change", "p-value", "Result");
+
+    int rowNo{0};
+    int numberOfRegressions{0};
+    int numberOfImprovements{0};
+
+    for (const auto &[key, candidate] : *candidateResults) {
+        auto colors = defaultColors;
+        const auto baselineEntry = baseline.find(key);
+
+        if (baselineEntry == baseline.end() || baselineEntry->second.hasError || candidate.hasError) {
+            const bool isNew = baselineEntry == baseline.end();
+            colors[resultColumn] = isNew ? PrintColor::Yellow : PrintColor::Magenta;
+            printTableRow(compareTableColumnWidths, colors, ++rowNo, key,
+                          isNew ? "-" : formatNumber(baselineEntry->second.mean, 1),
+                          formatNumber(candidate.mean, 1), "-", "-", isNew ? "NEW" : "ERROR");
+            if (!isNew) {
+                baseline.erase(baselineEntry);
+            }
+            continue;
+        }
+
+        const auto &reference = baselineEntry->second;
+        const double change = reference.mean > 0.0 ? (candidate.mean - reference.mean) / reference.mean : 0.0;
+        const auto pValue = welchTTest(reference, candidate);
+        const bool isSignificant =
+            pValue && *pValue < options->alpha && abs(change) * 100.0 >= options->thresholdPercent;
+
+        string result{"SAME"};
+        if (isSignificant && change > 0.0) {
+            result = "SLOWER";
+            colors[changeColumn] = colors[resultColumn] = PrintColor::Red;
+            ++numberOfRegressions;
+        } else if (isSignificant) {
+            result = "FASTER";
+            colors[changeColumn] = colors[resultColumn] = PrintColor::Green;
+            ++numberOfImprovements;
+        }
+
+        const auto changeText =
+            (change >= 0.0 ? "+" : "") + formatNumber(100.0 * change, 1) + "%" + significanceMarker(pValue);
+        printTableRow(compareTableColumnWidths, colors, ++rowNo, key, formatNumber(reference.mean, 1),
+                      formatNumber(candidate.mean, 1), changeText, pValue ? formatNumber(*pValue, 4) : "n/a",
+                      result);
+
+        baseline.erase(baselineEntry);
+    }
+
+    for (const auto &[key, reference] : baseline) {
+        auto colors = defaultColors;
+        colors[resultColumn] = PrintColor::Yellow;
+        printTableRow(compareTableColumnWidths, colors, ++rowNo, key, formatNumber(reference.mean, 1), "-",
+                      "-", "-", "MISSING");
+    }
+
+    const string summaryColor{numberOfRegressions == 0 ? PrintColor::Green : PrintColor::Red};
+    cout << endl;
+    cout << "COMPARISON SUMMARY: " << summaryColor << (numberOfRegressions == 0 ? "OK" : "REGRESSION")
+         << PrintColor::Reset << endl;
+    cout << "  " << numberOfRegressions << " slower and " << numberOfImprovements
+         << " faster benchmarks (change >= " << options->thresholdPercent << "%, p < " << options->alpha
+         << ")." << endl;
+    cout << "  Significance: * p < 0.05, ** p < 0.01, *** p < 0.001" << endl << endl;
+
+    return numberOfRegressions == 0 ? 0 : 1;
+}
+
+} // namespace gtest
+
+int main(int argc, char *argv[]) { return gtest::runBenchmarkCompare(argc, argv); }
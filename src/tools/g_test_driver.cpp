@@ -0,0 +1,522 @@
+/**
+ * @file g_test_driver.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Executes the tests of many test binaries in parallel and produces one merged report.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ * The tests of each binary are discovered with --list-tests and split into chunks based on the durations
+ * recorded by earlier runs. The chunks of all binaries are then scheduled longest first on a pool of
+ * processes, each chunk executed as "<binary> --filter=<tests> --results-json=<file>". With --fail-fast no
+ * more chunks are started after the first failure and the running ones are terminated.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "g_golden_file.hpp"
+#include "g_print_table.hpp"
+#include "g_test_report.hpp"
+
+extern char **environ;
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+constexpr double DefaultTestDuration{0.01};
+constexpr double MinChunkDuration{0.05};
+constexpr size_t ChunksPerJob{4};
+constexpr size_t MaxTestsPerChunk{1000};
+
+struct Options {
+    unsigned jobs{max(1U, thread::hardware_concurrency())};
+    filesystem::path durationsFile{".gtest_durations"};
+    filesystem::path resultsFile;
+    filesystem::path workDirectory;
+    bool isTemporaryWorkDirectory{false}; // Created by the driver, not given with --work-dir.
+    bool failFast{false};
+    string timeout; // Seconds per test case, passed on to the test processes.
+    vector<string> binaries;
+};
+
+struct Chunk {
+    size_t binaryIndex{0};
+    vector<string> testNames;
+    double estimatedDuration{0.0};
+    filesystem::path resultsFile;
+    filesystem::path logFile;
+};
+
+void printUsage() {
+    cout << "Usage: gtest_driver [options] <test binary>..." << endl;
+    cout << endl;
+    cout << "Options:" << endl;
+    cout << "  --jobs=<n>             Number of test processes to run in parallel, default number of cores."
+         << endl;
+    cout << "  --durations=<file>     Recorded test durations used for scheduling, default .gtest_durations."
+         << endl;
+    cout << "  --results-json=<file>  Write the merged results of all test binaries to a file." << endl;
+    cout << "  --work-dir=<dir>       Directory for the results and logs of each test process." << endl;
+    cout << "  --fail-fast            Stop all test processes at the first failure." << endl;
+    cout << "  --timeout=<seconds>    Abort a test process when one of its tests runs longer." << endl;
+}
+
+optional<Options> parseOptions(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const string_view argument{argv[i]};
+        const auto value = argument.substr(argument.find('=') + 1);
+
+        if (argument.starts_with("--jobs=")) {
+            int jobs{0};
+            const auto [end, error] = from_chars(value.data(), value.data() + value.size(), jobs);
+            if (error != errc{} || end != value.data() + value.size() || jobs < 1) {
+                cerr << "Invalid number of jobs: " << value << endl;
+                return nullopt;
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (argument.starts_with("--durations=")) {
+            options.durationsFile = value;
+        } else if (argument.starts_with("--results-json=")) {
+            options.resultsFile = value;
+        } else if (argument.starts_with("--work-dir=")) {
+            options.workDirectory = value;
+        } else if (argument == "--fail-fast") {
+            options.failFast = true;
+        } else if (argument.starts_with("--timeout=")) {
+            options.timeout = value;
+        } else if (argument.starts_with("--")) {
+            cerr << "Unknown option: " << argument << endl;
+            return nullopt;
+        } else {
+            options.binaries.emplace_back(argument);
+        }
+    }
+
+    if (options.binaries.empty()) {
+        return nullopt;
+    }
+
+    if (options.workDirectory.empty()) {
+        options.workDirectory = filesystem::temp_directory_path() / ("gtest_driver_" + to_string(getpid()));
+        options.isTemporaryWorkDirectory = true;
+    }
+
+    return options;
+}
+
+/**
+ * @brief Starts a process with stdout and stderr redirected to the given file descriptor.
+ */
+optional<pid_t> spawnProcess(const vector<string> &arguments, int outputFd) {
+    vector<char *> argv;
+    for (const auto &argument : arguments) {
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, outputFd, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, outputFd, STDERR_FILENO);
+
+    pid_t pid{0};
+    const int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (error != 0) {
+        cerr << "Could not start " << arguments[0] << ": " << strerror(error) << endl;
+        return nullopt;
+    }
+
+    return pid;
+}
+
+string describeExitStatus(int status) {
+    if (WIFSIGNALED(status)) {
+        return "killed by signal " + to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+    }
+    return "exited with status " + to_string(WEXITSTATUS(status));
+}
+
+/**
+ * @brief Gives the names of the tests in a test binary, using its --list-tests output.
+ */
+optional<vector<string>> discoverTests(const string &binary) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        return nullopt;
+    }
+
+    const auto pid = spawnProcess({binary, "--list-tests"}, pipeFds[1]);
+    close(pipeFds[1]);
+
+    string output;
+    char buffer[4096];
+    for (ssize_t count; (count = read(pipeFds[0], buffer, sizeof(buffer))) > 0;) {
+        output.append(buffer, static_cast<size_t>(count));
+    }
+    close(pipeFds[0]);
+
+    int status{0};
+    if (!pid || waitpid(*pid, &status, 0) != *pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        cerr << "Could not list the tests of " << binary << endl;
+        return nullopt;
+    }
+
+    // Each line is "<test name> <file>:<line>".
+    vector<string> testNames;
+    stringstream lines(output);
+    for (string line; getline(lines, line);) {
+        if (const auto name = line.substr(0, line.find(' ')); !name.empty()) {
+            testNames.push_back(name);
+        }
+    }
+
+    return testNames;
+}
+
+string durationKey(string_view binary, string_view testName) {
+    return string{binary} + '\t' + string{testName};
+}
+
+map<string, double> loadDurations(const filesystem::path &path) {
+    map<string, double> durations;
+    ifstream file(path);
+
+    // Each line is "<binary>\t<test name>\t<seconds>".
+    for (string line; getline(file, line);) {
+        const auto separator = line.rfind('\t');
+        if (separator != string::npos && separator > 0) {
+            durations[line.substr(0, separator)] = strtod(line.c_str() + separator + 1, nullptr);
+        }
+    }
+
+    return durations;
+}
+
+void saveDurations(const filesystem::path &path, const map<string, double> &durations) {
+    stringstream contents;
+    for (const auto &[key, seconds] : durations) {
+        contents << key << '\t' << seconds << '\n';
+    }
+
+    const auto text = contents.str();
+    writeFileAtomically(path, as_bytes(span{text.data(), text.size()}));
+}
+
+/**
+ * @brief Splits the tests of all binaries into chunks of about the same estimated duration, sorted with
+ * the longest chunk first.
+ */
+vector<Chunk> createChunks(const Options &options, const vector<vector<string>> &testsPerBinary,
+                           const map<string, double> &durations) {
+    const auto estimate = [&](size_t binaryIndex, const string &testName) {
+        const auto duration = durations.find(durationKey(options.binaries[binaryIndex], testName));
+        return duration != durations.end() ? duration->second : DefaultTestDuration;
+    };
+
+    double totalDuration{0.0};
+    for (size_t binaryIndex = 0; binaryIndex < testsPerBinary.size(); ++binaryIndex) {
+        for (const auto &testName : testsPerBinary[binaryIndex]) {
+            totalDuration += estimate(binaryIndex, testName);
+        }
+    }
+
+    const auto targetDuration = max(MinChunkDuration, totalDuration / (options.jobs * ChunksPerJob));
+    vector<Chunk> chunks;
+
+    for (size_t binaryIndex = 0; binaryIndex < testsPerBinary.size(); ++binaryIndex) {
+        Chunk chunk;
+        chunk.binaryIndex = binaryIndex;
+
+        for (const auto &testName : testsPerBinary[binaryIndex]) {
+            chunk.testNames.push_back(testName);
+            chunk.estimatedDuration += estimate(binaryIndex, testName);
+
+            if (chunk.estimatedDuration >= targetDuration || chunk.testNames.size() >= MaxTestsPerChunk) {
+                chunks.push_back(std::move(chunk));
+                chunk = Chunk{};
+                chunk.binaryIndex = binaryIndex;
+            }
+        }
+
+        if (!chunk.testNames.empty()) {
+            chunks.push_back(std::move(chunk));
+        }
+    }
+
+    ranges::stable_sort(chunks, greater{}, &Chunk::estimatedDuration);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].resultsFile = options.workDirectory / ("chunk_" + to_string(i) + ".json");
+        chunks[i].logFile = options.workDirectory / ("chunk_" + to_string(i) + ".log");
+    }
+
+    return chunks;
+}
+
+/**
+ * @brief Writes a record to the merged results for a test without a result, with the status "NO RESULT"
+ * or "SKIPPED", so that gtest_merge counts it like the driver does, see TestReport::addResult().
+ */
+void writeMissingResultJson(ostream &os, string_view binary, string_view testName, string_view status,
+                            string_view reason = {}) {
+    os << "{\"binary\":";
+    writeJsonString(os, binary);
+    os << ",\"name\":";
+    writeJsonString(os, testName);
+    os << ",\"status\":";
+    writeJsonString(os, status);
+    if (!reason.empty()) {
+        os << ",\"reason\":";
+        writeJsonString(os, reason);
+    }
+    os << "}\n";
+}
+
+optional<pid_t> startChunk(const Options &options, const Chunk &chunk) {
+    string filter;
+    for (const auto &testName : chunk.testNames) {
+        filter += (filter.empty() ? "" : ",") + testName;
+    }
+
+    const int logFd = open(chunk.logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (logFd == -1) {
+        cerr << "Could not create " << chunk.logFile.string() << ": " << strerror(errno) << endl;
+        return nullopt;
+    }
+
+    vector<string> arguments{options.binaries[chunk.binaryIndex], "--filter=" + filter,
+                             "--results-json=" + chunk.resultsFile.string()};
+    if (options.failFast) {
+        arguments.emplace_back("--fail-fast");
+    }
+    if (!options.timeout.empty()) {
+        arguments.push_back("--timeout=" + options.timeout);
+    }
+
+    const auto pid = spawnProcess(arguments, logFd);
+    close(logFd);
+    return pid;
+}
+
+} // namespace
+
+/**
+ * @brief Runs the test driver.
+ *
+ * @return The exit code of the driver, 0 if all tests passed.
+ */
+int runTestDriver(int argc, char *argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        printUsage();
+        return 2;
+    }
+
+    vector<vector<string>> testsPerBinary;
+    for (const auto &binary : options->binaries) {
+        auto testNames = discoverTests(binary);
+        if (!testNames) {
+            return 2;
+        }
+        testsPerBinary.push_back(std::move(*testNames));
+    }
+
+    auto durations = loadDurations(options->durationsFile);
+    auto chunks = createChunks(*options, testsPerBinary, durations);
+
+    filesystem::create_directories(options->workDirectory);
+
+    ofstream mergedResults;
+    if (!options->resultsFile.empty()) {
+        mergedResults.open(options->resultsFile, ios::trunc);
+    }
+
+    const vector<int> chunkTableColumnWidths{6, 30, 10, 10, 15};
+    auto colors = vector<string>(chunkTableColumnWidths.size(), PrintColor::Reset);
+    printTableRow(chunkTableColumnWidths, colors, "Chunk", "Test Binary", "Tests", "Failed", "Status");
+
+    TestReport report;
+    map<pid_t, size_t> runningChunks;
+    size_t nextChunk{0};
+    bool isStopping{false};
+
+    const auto skipTest = [&](size_t binaryIndex, const string &testName) {
+        report.addSkippedTest();
+        if (mergedResults) {
+            writeMissingResultJson(mergedResults, options->binaries[binaryIndex], testName, "SKIPPED");
+        }
+    };
+
+    const auto finishChunk = [&](size_t chunkIndex, int exitStatus) {
+        const auto &chunk = chunks[chunkIndex];
+        const auto &binary = options->binaries[chunk.binaryIndex];
+        const auto binaryName = filesystem::path(binary).filename().string();
+        const auto statisticsBefore = report.getStatistics();
+        set<string, less<>> reportedTests;
+
+        forEachJsonLine(chunk.resultsFile, [&](const JsonValue &record, string_view line) {
+            const auto testName = record.stringAt("name");
+            report.addResult(record, binaryName);
+            reportedTests.emplace(testName);
+            durations[durationKey(binary, testName)] = record.numberAt("durationNs") / 1e9;
+
+            if (mergedResults && line.starts_with('{')) {
+                // Insert the binary the record comes from as the first member.
+                mergedResults << "{\"binary\":";
+                writeJsonString(mergedResults, binary);
+                mergedResults << (line == "{}" ? "" : ",") << line.substr(1) << '\n';
+            }
+        });
+
+        // A process terminated by the driver, or one which stopped at its first failure, leaves the rest of
+        // its tests unexecuted rather than crashed.
+        const auto &statistics = report.getStatistics();
+        const auto failedTests = statistics.numberOfFailedTests - statisticsBefore.numberOfFailedTests;
+        const auto testsWithExceptions =
+            statistics.numberOfTestsWithExceptions - statisticsBefore.numberOfTestsWithExceptions;
+        const bool hasFailure = failedTests > 0 || testsWithExceptions > 0;
+        const bool isTerminated = isStopping && WIFSIGNALED(exitStatus) && WTERMSIG(exitStatus) == SIGTERM;
+        const bool isStoppedEarly = options->failFast && hasFailure && WIFEXITED(exitStatus);
+
+        // The tests are executed in order, so the first test without a result is the one that was running
+        // when the process died. The tests after it are executed again in a new chunk.
+        int missingTests{0};
+        Chunk retryChunk;
+        retryChunk.binaryIndex = chunk.binaryIndex;
+        for (const auto &testName : chunk.testNames) {
+            if (reportedTests.contains(testName)) {
+                continue;
+            }
+            if (isTerminated || isStoppedEarly) {
+                skipTest(chunk.binaryIndex, testName);
+            } else if (missingTests++ == 0) {
+                const auto reason = describeExitStatus(exitStatus) + ", see " + chunk.logFile.string();
+                report.addMissingResult(binaryName, testName, reason);
+                if (mergedResults) {
+                    writeMissingResultJson(mergedResults, binary, testName, "NO RESULT", reason);
+                }
+            } else {
+                retryChunk.testNames.push_back(testName);
+            }
+        }
+
+        string status{"PASSED"};
+        colors.back() = PrintColor::Green;
+        if (isTerminated) {
+            status = "CANCELLED";
+            colors.back() = PrintColor::Yellow;
+        } else if (missingTests > 0) {
+            status = "NO RESULT";
+            colors.back() = PrintColor::Magenta;
+        } else if (failedTests > 0) {
+            status = "FAILED";
+            colors.back() = PrintColor::Red;
+        } else if (testsWithExceptions > 0) {
+            status = "EXCEPTION";
+            colors.back() = PrintColor::Magenta;
+        }
+
+        printTableRow(chunkTableColumnWidths, colors, chunkIndex + 1, binaryName, chunk.testNames.size(),
+                      failedTests, status);
+        colors.back() = PrintColor::Reset;
+
+        if (options->failFast) {
+            for (const auto &testName : retryChunk.testNames) {
+                skipTest(retryChunk.binaryIndex, testName);
+            }
+        } else if (!retryChunk.testNames.empty()) {
+            const auto chunkName = "chunk_" + to_string(chunks.size());
+            retryChunk.resultsFile = options->workDirectory / (chunkName + ".json");
+            retryChunk.logFile = options->workDirectory / (chunkName + ".log");
+            chunks.push_back(std::move(retryChunk)); // Invalidates chunk, keep last.
+        }
+    };
+
+    while ((!isStopping && nextChunk < chunks.size()) || !runningChunks.empty()) {
+        while (!isStopping && runningChunks.size() < options->jobs && nextChunk < chunks.size()) {
+            if (const auto pid = startChunk(*options, chunks[nextChunk])) {
+                runningChunks[*pid] = nextChunk;
+            } else {
+                finishChunk(nextChunk, 0);
+            }
+            ++nextChunk;
+        }
+
+        int status{0};
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (const auto running = runningChunks.find(pid); running != runningChunks.end()) {
+            finishChunk(running->second, status);
+            runningChunks.erase(running);
+        }
+
+        if (options->failFast && !isStopping && !report.isSuccess()) {
+            isStopping = true;
+            for (const auto &[runningPid, chunkIndex] : runningChunks) {
+                kill(runningPid, SIGTERM);
+            }
+        }
+    }
+
+    for (size_t i = nextChunk; i < chunks.size(); ++i) {
+        for (const auto &testName : chunks[i].testNames) {
+            skipTest(chunks[i].binaryIndex, testName);
+        }
+    }
+
+    report.printSummary();
+    saveDurations(options->durationsFile, durations);
+
+    if (report.isSuccess()) {
+        error_code error;
+        if (options->isTemporaryWorkDirectory) {
+            filesystem::remove_all(options->workDirectory, error);
+        } else {
+            // A directory given with --work-dir may hold other files, so only the files of the chunks go.
+            for (const auto &chunk : chunks) {
+                filesystem::remove(chunk.resultsFile, error);
+                filesystem::remove(chunk.logFile, error);
+            }
+        }
+    }
+
+    return report.isSuccess() ? 0 : 1;
+}
+
+} // namespace gtest
+
+int main(int argc, char *argv[]) { return gtest::runTestDriver(argc, argv); }
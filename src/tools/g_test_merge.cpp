@@ -0,0 +1,150 @@
+/**
+ * @file g_test_merge.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Merges the results files of test shards into one summary.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ * Each input is a results file written by --results-json or gtest_driver, or a directory whose *.json
+ * files are merged. The files are streamed one line at a time, so only the failure details are kept in
+ * memory regardless of the number of shards.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "g_test_report.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+struct Options {
+    filesystem::path resultsFile;
+    vector<filesystem::path> inputs;
+};
+
+void printUsage() {
+    cout << "Usage: gtest_merge [options] <results file or directory>..." << endl;
+    cout << endl;
+    cout << "Options:" << endl;
+    cout << "  --results-json=<file>  Write the merged results of all shards to a file." << endl;
+}
+
+optional<Options> parseOptions(int argc, char *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const string_view argument{argv[i]};
+
+        if (argument.starts_with("--results-json=")) {
+            options.resultsFile = argument.substr(argument.find('=') + 1);
+        } else if (argument.starts_with("--")) {
+            cerr << "Unknown option: " << argument << endl;
+            return nullopt;
+        } else {
+            options.inputs.emplace_back(argument);
+        }
+    }
+
+    if (options.inputs.empty()) {
+        return nullopt;
+    }
+
+    return options;
+}
+
+/**
+ * @brief Expands directories to the *.json files they contain, sorted by name so that the merged results
+ * are deterministic. The output file is left out, so that a merge into one of the input directories does
+ * not read its own results.
+ */
+vector<filesystem::path> expandInputs(const vector<filesystem::path> &inputs,
+                                      const filesystem::path &output) {
+    vector<filesystem::path> files;
+    const auto isOutput = [&](const filesystem::path &file) {
+        error_code error;
+        return !output.empty() && filesystem::equivalent(file, output, error);
+    };
+
+    for (const auto &input : inputs) {
+        if (!filesystem::is_directory(input)) {
+            if (!isOutput(input)) {
+                files.push_back(input);
+            }
+            continue;
+        }
+
+        const auto firstFile = files.size();
+        for (const auto &entry : filesystem::directory_iterator(input)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json" && !isOutput(entry.path())) {
+                files.push_back(entry.path());
+            }
+        }
+        sort(files.begin() + static_cast<ptrdiff_t>(firstFile), files.end());
+    }
+
+    return files;
+}
+
+} // namespace
+
+/**
+ * @brief Runs the merge tool.
+ *
+ * @return The exit code of the tool, 0 if all merged tests passed.
+ */
+int runTestMerge(int argc, char *argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        printUsage();
+        return 2;
+    }
+
+    ofstream mergedResults;
+    if (!options->resultsFile.empty()) {
+        mergedResults.open(options->resultsFile, ios::trunc);
+    }
+
+    TestReport report;
+    bool allInputsRead{true};
+
+    for (const auto &file : expandInputs(options->inputs, options->resultsFile)) {
+        const auto isRead = forEachJsonLine(file, [&](const JsonValue &record, string_view line) {
+            // Records merged by gtest_driver tell which test binary they come from.
+            const auto binary = record.stringAt("binary");
+            report.addResult(record, filesystem::path(binary).filename().string());
+
+            if (mergedResults) {
+                mergedResults << line << '\n';
+            }
+        });
+
+        if (!isRead) {
+            cerr << "Could not read " << file.string() << endl;
+            allInputsRead = false;
+        }
+    }
+
+    report.printSummary();
+
+    if (!allInputsRead) {
+        return 2;
+    }
+    return report.isSuccess() ? 0 : 1;
+}
+
+} // namespace gtest
+
+int main(int argc, char *argv[]) { return gtest::runTestMerge(argc, argv); }
@@ -0,0 +1,166 @@
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "g_print_table.hpp"
+#include "g_test_report.hpp"
+
+using namespace std;
+
+namespace gtest {
+
+namespace {
+
+string qualifiedName(string_view source, string_view testName) {
+    return source.empty() ? string{testName} : string{source} + ":" + string{testName};
+}
+
+CounterKind counterKindFromText(string_view text) {
+    if (text == "rate") {
+        return CounterKind::Rate;
+    } else if (text == "average") {
+        return CounterKind::Average;
+    }
+    return CounterKind::Total;
+}
+
+} // namespace
+
+bool forEachJsonLine(const filesystem::path &path,
+                     const function<void(const JsonValue &, string_view)> &callback) {
+    ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    string line;
+    while (getline(file, line)) {
+        if (auto document = JsonValue::parse(line)) {
+            callback(*document, line);
+        }
+    }
+
+    return true;
+}
+
+void TestReport::addResult(const JsonValue &record, string_view source) {
+    const auto status = record.stringAt("status");
+    if (status == "NO RESULT") {
+        addMissingResult(source, record.stringAt("name"), record.stringAt("reason"));
+        return;
+    } else if (status == "SKIPPED") {
+        addSkippedTest();
+        return;
+    }
+
+    const auto name = qualifiedName(source, record.stringAt("name"));
+    const auto numberOfChecks = static_cast<long long>(record.numberAt("checks"));
+    const auto numberOfFailedChecks = static_cast<long long>(record.numberAt("failedChecks"));
+    const auto &failures = record.arrayAt("failures");
+    const auto &exceptions = record.arrayAt("exceptions");
+
+    ++statistics_.numberOfExecutedTests;
+    statistics_.numberOfExecutedChecks += numberOfChecks;
+    statistics_.numberOfFailedChecks += numberOfFailedChecks;
+
+    if (numberOfFailedChecks > 0) {
+        ++statistics_.numberOfFailedTests;
+    } else if (numberOfChecks > 0) {
+        ++statistics_.numberOfPassedTests;
+    }
+
+    if (!exceptions.empty()) {
+        ++statistics_.numberOfTestsWithExceptions;
+    }
+
+    for (const auto &check : failures) {
+        const auto *fatal = check.find("fatal");
+        stringstream line;
+        line << (fatal != nullptr && fatal->asBool() ? "# Assertion failed: " : "# Failed: ") << name
+             << " check " << check.numberAt("check") << " (" << check.stringAt("name") << ") | "
+             << check.stringAt("message");
+        failureLines_.push_back(line.str());
+    }
+
+    const auto numberOfOmittedFailures = numberOfFailedChecks - ssize(failures);
+    if (numberOfOmittedFailures > 0) {
+        failureLines_.push_back("# Failed: " + name + " +" + to_string(numberOfOmittedFailures) + " more");
+    }
+
+    for (const auto &exception : exceptions) {
+        exceptionLines_.push_back("# Exception: " + name + " " + string{exception.stringAt("type")} + "(" +
+                                  string{exception.stringAt("message")} + ")");
+    }
+
+    for (const auto &counter : record.arrayAt("counters")) {
+        const UserCounter userCounter{.name = string{counter.stringAt("name")},
+                                      .kind = counterKindFromText(counter.stringAt("kind")),
+                                      .value = counter.numberAt("value")};
+        counterRows_.push_back(CounterRow{.testName = name, .counter = userCounter});
+    }
+}
+
+void TestReport::addMissingResult(string_view source, string_view testName, string_view reason) {
+    ++numberOfMissingResults_;
+    missingResultLines_.push_back("# No result: " + qualifiedName(source, testName) + " | " + string{reason});
+}
+
+void TestReport::printCounters() const {
+    const vector<int> userCountersTableColumnWidths{4, 30, 20, 10, 16};
+    const auto colors = vector<string>(userCountersTableColumnWidths.size(), PrintColor::Reset);
+
+    cout << endl << "COUNTERS:" << endl;
+    printTableRow(userCountersTableColumnWidths, colors, "#", "Test Name", "Counter", "Kind", "Value");
+
+    int rowNo{0};
+    for (const auto &row : counterRows_) {
+        stringstream kind;
+        kind << row.counter.kind;
+        printTableRow(userCountersTableColumnWidths, colors, ++rowNo, row.testName, row.counter.name,
+                      kind.str(), counterValueText(row.counter));
+    }
+}
+
+void TestReport::printSummary() const {
+    if (!counterRows_.empty()) {
+        printCounters();
+    }
+
+    const string result{isSuccess() ? "SUCCESS!" : "FAILED"};
+    const string resultColor{isSuccess() ? PrintColor::Green : PrintColor::Red};
+
+    cout << endl;
+    cout << "TEST SUMMARY: " << resultColor << result << PrintColor::Reset << endl;
+    cout << "  " << statistics_.numberOfExecutedChecks << " checks executed for "
+         << statistics_.numberOfExecutedTests << " test cases." << endl;
+    if (statistics_.numberOfFailedTests > 0) {
+        cout << "  " << statistics_.numberOfPassedTests << " passed tests " << statistics_.numberOfFailedTests
+             << " failed tests." << endl;
+    }
+    if (statistics_.numberOfTestsWithExceptions > 0) {
+        cout << "  " << statistics_.numberOfTestsWithExceptions << " tests was terminated with an exception."
+             << endl;
+    }
+    if (numberOfMissingResults_ > 0) {
+        cout << "  " << numberOfMissingResults_ << " tests did not report a result." << endl;
+    }
+    if (numberOfSkippedTests_ > 0) {
+        cout << "  " << numberOfSkippedTests_ << " tests were not executed after the first failure." << endl;
+    }
+    cout << endl;
+
+    for (const auto *lines : {&failureLines_, &exceptionLines_, &missingResultLines_}) {
+        for (const auto &line : *lines) {
+            cout << line << endl;
+        }
+    }
+
+    cout << endl << endl;
+}
+
+} // namespace gtest
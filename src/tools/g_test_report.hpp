@@ -0,0 +1,93 @@
+/**
+ * @file g_test_report.hpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Aggregation of results files written by test binaries, used by the test tools.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "g_json.hpp"
+#include "g_test_framework.hpp"
+#include "g_user_counters.hpp"
+
+#pragma once
+
+namespace gtest {
+
+/**
+ * @brief Reads a file with one JSON document per line, as written by --results-json, and calls the
+ * callback with each parsed document and the line it was parsed from. Lines which are not valid JSON are
+ * skipped. Only one line at a time is kept in memory.
+ *
+ * @return False if the file could not be opened.
+ */
+bool forEachJsonLine(const std::filesystem::path &path,
+                     const std::function<void(const JsonValue &, std::string_view)> &callback);
+
+/**
+ * @brief Aggregates test results read from results files into one summary, in the same format as the
+ * summary printed by the test framework. Only the failure details and the user counters are kept in
+ * memory, so any number of results can be added.
+ */
+class TestReport {
+  public:
+    /**
+     * @brief Adds a test result record as written by --results-json. Records with the status "NO RESULT"
+     * or "SKIPPED", which gtest_driver writes for tests without a result, are added as with
+     * addMissingResult() and addSkippedTest().
+     *
+     * @param record The test result record.
+     * @param source Prefix for the test name in the summary, e.g. the test binary. May be empty.
+     */
+    void addResult(const JsonValue &record, std::string_view source);
+
+    /**
+     * @brief Adds a test case which did not report any result, e.g. because its process crashed.
+     */
+    void addMissingResult(std::string_view source, std::string_view testName, std::string_view reason);
+
+    /**
+     * @brief Adds a test case which was not executed because the run stopped at the first failure.
+     */
+    void addSkippedTest() { ++numberOfSkippedTests_; }
+
+    /**
+     * @brief Tells if all test cases reported a result without failed checks or exceptions.
+     */
+    bool isSuccess() const { return statistics_.isSuccess() && numberOfMissingResults_ == 0; }
+
+    const TestRunStatistics &getStatistics() const { return statistics_; }
+
+    /**
+     * @brief Prints the summary to cout, preceded by a COUNTERS table if any test case reported user
+     * counters.
+     */
+    void printSummary() const;
+
+  private:
+    struct CounterRow {
+        std::string testName;
+        UserCounter counter;
+    };
+
+    void printCounters() const;
+
+    TestRunStatistics statistics_;
+    int numberOfMissingResults_ = 0;
+    int numberOfSkippedTests_ = 0;
+    std::vector<std::string> failureLines_;
+    std::vector<std::string> exceptionLines_;
+    std::vector<std::string> missingResultLines_;
+    std::vector<CounterRow> counterRows_;
+};
+
+} // namespace gtest
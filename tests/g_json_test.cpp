@@ -0,0 +1,74 @@
+/**
+ * @file g_json_test.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Tests of the JSON writer and parser used by the results files and the tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "g_json.hpp"
+#include "g_test_framework.hpp"
+
+using namespace std;
+using gtest::JsonValue;
+
+namespace test {
+
+GTEST(JsonStringRoundTrip) {
+    const string texts[] = {"", "plain", "quote \" and backslash \\", "line\nfeed\r\ttab",
+                            string{"control \x01\x1f and nul "} + '\0', "utf-8 \xc3\xa5\xe2\x82\xac"};
+
+    for (const auto &text : texts) {
+        stringstream json;
+        gtest::writeJsonString(json, text);
+
+        const auto parsed = JsonValue::parse(json.str());
+        GASSERT(json.str(), parsed.has_value(), true);
+        GCHECK(json.str(), string{parsed->asString()}, text);
+    }
+}
+
+GTEST(JsonParsesNestedValues) {
+    const auto parsed = JsonValue::parse(R"( {"name":"a\u00e5","values":[1, -2.5e3, 0.125],
+                                             "nested":{"flag":true,"empty":null},"list":[]} )");
+    GASSERT(string{"valid"}, parsed.has_value(), true);
+
+    GCHECK(string{"string"}, parsed->stringAt("name"), string_view{"a\xc3\xa5"});
+    const auto &values = parsed->arrayAt("values");
+    GASSERT(string{"array size"}, values.size(), size_t{3});
+    GCHECK(string{"integer"}, values[0].asNumber(), 1.0);
+    GCHECK(string{"exponent"}, values[1].asNumber(), -2500.0);
+    GCHECK(string{"fraction"}, values[2].asNumber(), 0.125);
+
+    const auto *nested = parsed->find("nested");
+    GASSERT(string{"nested object"}, nested != nullptr && nested->isObject(), true);
+    GCHECK(string{"bool"}, nested->find("flag")->asBool(), true);
+    GCHECK(string{"null"}, nested->find("empty")->isNull(), true);
+    GCHECK(string{"empty array"}, parsed->arrayAt("list").empty(), true);
+    GCHECK(string{"missing member"}, parsed->find("missing") == nullptr, true);
+    GCHECK(string{"default"}, parsed->numberAt("name", -1.0), -1.0);
+}
+
+GTEST(JsonRejectsInvalidDocuments) {
+    const string_view documents[] = {"",       "{",          "{\"a\":}",      "{\"a\" 1}",  "[1,]",
+                                     "[1 2]",  "\"open",     "\"bad \\u12\"", "tru",        "+1",
+                                     "1.2.3",  "{} {}",      "{'a':1}",       "nul"};
+
+    for (const auto document : documents) {
+        GCHECK(string{document}, JsonValue::parse(document).has_value(), false);
+    }
+
+    GCHECK(string{"nesting limit"}, JsonValue::parse(string(100, '[') + string(100, ']')).has_value(), false);
+    GCHECK(string{"within the nesting limit"},
+           JsonValue::parse(string(10, '[') + string(10, ']')).has_value(), true);
+}
+
+} // namespace test
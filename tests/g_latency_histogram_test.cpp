@@ -0,0 +1,80 @@
+/**
+ * @file g_latency_histogram_test.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Tests of the latency histogram used by the benchmarks.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "g_latency_histogram.hpp"
+#include "g_test_framework.hpp"
+
+using namespace std;
+using gtest::LatencyHistogram;
+
+namespace test {
+
+GTEST(PercentileOfEmptyHistogram) {
+    const LatencyHistogram histogram;
+
+    GCHECK(string{"p50"}, histogram.percentile(50.0), uint64_t{0});
+    GCHECK(string{"max"}, histogram.getMax(), uint64_t{0});
+    GCHECK(string{"min"}, histogram.getMin(), uint64_t{0});
+}
+
+GTEST(PercentileOfSmallValuesIsExact) {
+    LatencyHistogram histogram;
+    for (uint64_t latency = 1; latency <= 100; ++latency) {
+        histogram.record(latency);
+    }
+
+    GCHECK(string{"count"}, histogram.getCount(), uint64_t{100});
+    GCHECK(string{"p0"}, histogram.percentile(0.0), uint64_t{1});
+    GCHECK(string{"p50"}, histogram.percentile(50.0), uint64_t{50});
+    GCHECK(string{"p99"}, histogram.percentile(99.0), uint64_t{99});
+    GCHECK(string{"p99.9"}, histogram.percentile(99.9), uint64_t{100});
+    GCHECK(string{"p100"}, histogram.percentile(100.0), uint64_t{100});
+    GCHECK(string{"above 100"}, histogram.percentile(250.0), uint64_t{100});
+}
+
+GTEST(PercentileOfLargeValuesIsWithinTheBucketError) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 99; ++i) {
+        histogram.record(1'000'000);
+    }
+    histogram.record(5'000'000'000);
+
+    // A bucket spans 1/64 of its power of two, and the upper bound of the bucket is reported.
+    const auto p50 = histogram.percentile(50.0);
+    GCHECK(string{"p50 not below the value"}, p50 >= 1'000'000, true);
+    GCHECK(string{"p50 within 1/64"}, p50 - 1'000'000 <= 1'000'000 / 64, true);
+    GCHECK(string{"p100 is the maximum"}, histogram.percentile(100.0), uint64_t{5'000'000'000});
+}
+
+GTEST(PercentileOfMergedHistograms) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 90; ++i) {
+        fast.record(10);
+    }
+    for (int i = 0; i < 10; ++i) {
+        slow.record(20);
+    }
+
+    fast.merge(slow);
+
+    GCHECK(string{"count"}, fast.getCount(), uint64_t{100});
+    GCHECK(string{"p90"}, fast.percentile(90.0), uint64_t{10});
+    GCHECK(string{"p91"}, fast.percentile(91.0), uint64_t{20});
+    GCHECK(string{"min"}, fast.getMin(), uint64_t{10});
+    GCHECK(string{"max"}, fast.getMax(), uint64_t{20});
+    GCHECKT(string{"mean"}, fast.getMean(), 11.0, 1e-9);
+}
+
+} // namespace test
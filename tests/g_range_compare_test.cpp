@@ -0,0 +1,62 @@
+/**
+ * @file g_range_compare_test.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Tests of the floating point comparisons used by the range checks.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "g_range_compare.hpp"
+#include "g_test_framework.hpp"
+
+using namespace std;
+using namespace gtest::compare;
+
+namespace test {
+
+// Values of opposite sign far apart must not wrap around in the distance computation.
+static_assert(ulpDistance(-0.0f, 0.0f) == 0 && ulpDistance(-1.0f, 1.0f) == 2 * 0x3f800000u);
+static_assert(!isWithinUlps(-3e38f, 3e38f, 30000000));
+static_assert(ulpDistance(-numeric_limits<float>::infinity(), numeric_limits<float>::infinity()) ==
+              2 * 0x7f800000u);
+static_assert(ulpDistance(numeric_limits<double>::max(), numeric_limits<double>::lowest()) ==
+              2 * 0x7fefffffffffffffu);
+
+GTEST(UlpDistanceCountsRepresentableValues) {
+    GCHECK(string{"equal"}, ulpDistance(1.0, 1.0), uint64_t{0});
+    GCHECK(string{"adjacent float"}, ulpDistance(1.0f, nextafter(1.0f, 2.0f)), uint64_t{1});
+    GCHECK(string{"adjacent double"}, ulpDistance(nextafter(1.0, 0.0), 1.0), uint64_t{1});
+    GCHECK(string{"across a power of two"}, ulpDistance(nextafter(2.0f, 0.0f), nextafter(2.0f, 4.0f)),
+           uint64_t{2});
+
+    constexpr auto denormal = numeric_limits<float>::denorm_min();
+    GCHECK(string{"zero to denormal"}, ulpDistance(0.0f, denormal), uint64_t{1});
+    GCHECK(string{"across zero"}, ulpDistance(-denormal, denormal), uint64_t{2});
+    GCHECK(string{"symmetric"}, ulpDistance(-2.5, 3.5), ulpDistance(3.5, -2.5));
+}
+
+GTEST(IsWithinUlpsComparesWithTheLimit) {
+    const auto next = nextafter(1.0f, 2.0f);
+    GCHECK(string{"at the limit"}, isWithinUlps(next, 1.0f, 1), true);
+    GCHECK(string{"beyond the limit"}, isWithinUlps(nextafter(next, 2.0f), 1.0f, 1), false);
+    GCHECK(string{"zeros"}, isWithinUlps(-0.0, 0.0, 0), true);
+    GCHECK(string{"infinity"}, isWithinUlps(numeric_limits<double>::infinity(),
+                                            numeric_limits<double>::infinity(), 0), true);
+}
+
+GTEST(IsWithinUlpsRejectsNaN) {
+    const auto nan = numeric_limits<double>::quiet_NaN();
+    GCHECK(string{"NaN result"}, isWithinUlps(nan, 1.0, numeric_limits<uint64_t>::max()), false);
+    GCHECK(string{"NaN expected"}, isWithinUlps(1.0, nan, numeric_limits<uint64_t>::max()), false);
+    GCHECK(string{"both NaN"}, isWithinUlps(nan, nan, numeric_limits<uint64_t>::max()), false);
+}
+
+} // namespace test
@@ -0,0 +1,74 @@
+/**
+ * @file g_test_report_test.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Tests of the merging of test results by the tools.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include <string>
+#include <string_view>
+
+#include "g_json.hpp"
+#include "g_test_framework.hpp"
+#include "tools/g_test_report.hpp"
+
+using namespace std;
+using gtest::JsonValue;
+using gtest::TestReport;
+
+namespace test {
+
+namespace {
+
+void addRecord(TestReport &report, string_view line, string_view source) {
+    report.addResult(JsonValue::parse(line).value(), source);
+}
+
+} // namespace
+
+GTEST(TestReportMergesShards) {
+    TestReport report;
+    addRecord(report, R"({"name":"A","status":"PASSED","checks":3,"failedChecks":0,"failures":[],
+                          "exceptions":[]})", "shard1");
+    addRecord(report, R"({"name":"B","status":"FAILED","checks":4,"failedChecks":2,
+                          "failures":[{"check":2,"name":"x","message":"m","fatal":false}],"exceptions":[]})",
+              "shard1");
+    addRecord(report, R"({"name":"C","status":"EXCEPTION","checks":1,"failedChecks":0,"failures":[],
+                          "exceptions":[{"type":"runtime_error","message":"boom"}]})", "shard2");
+
+    const auto &statistics = report.getStatistics();
+    GCHECK(string{"tests"}, statistics.numberOfExecutedTests, 3);
+    GCHECK(string{"passed"}, statistics.numberOfPassedTests, 2);
+    GCHECK(string{"failed"}, statistics.numberOfFailedTests, 1);
+    GCHECK(string{"exceptions"}, statistics.numberOfTestsWithExceptions, 1);
+    GCHECK(string{"checks"}, statistics.numberOfExecutedChecks, 8LL);
+    GCHECK(string{"failed checks"}, statistics.numberOfFailedChecks, 2LL);
+    GCHECK(string{"success"}, report.isSuccess(), false);
+}
+
+GTEST(TestReportOfPassedShardsIsSuccess) {
+    TestReport report;
+    for (const auto *shard : {"shard1", "shard2"}) {
+        addRecord(report, R"({"name":"A","status":"PASSED","checks":2,"failedChecks":0})", shard);
+    }
+
+    GCHECK(string{"tests"}, report.getStatistics().numberOfExecutedTests, 2);
+    GCHECK(string{"checks"}, report.getStatistics().numberOfExecutedChecks, 4LL);
+    GCHECK(string{"success"}, report.isSuccess(), true);
+}
+
+GTEST(TestReportCountsMissingResults) {
+    TestReport report;
+    addRecord(report, R"({"name":"A","status":"PASSED","checks":1,"failedChecks":0})", "shard1");
+    addRecord(report, R"({"binary":"./t","name":"B","status":"NO RESULT","reason":"crashed"})", "shard1");
+    addRecord(report, R"({"binary":"./t","name":"C","status":"SKIPPED"})", "shard1");
+
+    GCHECK(string{"executed tests"}, report.getStatistics().numberOfExecutedTests, 1);
+    GCHECK(string{"success"}, report.isSuccess(), false);
+}
+
+} // namespace test
@@ -0,0 +1,14 @@
+/**
+ * @file run_tests.cpp
+ * @author ImproperDecoherence (gustowny@gmail.com)
+ * @brief Executes the tests of the test framework itself.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * Copyright (c) 2024-2026 Jonas Gustavsson
+ *
+ */
+
+#include "g_test_framework.hpp"
+
+int main(int argc, char *argv[]) { return gtest::TestFramework::getInstance().executeTests(argc, argv); }